@@ -0,0 +1,52 @@
+/** @file Convolution.h
+ *  @brief Separable image filters for PPM images on the CPU
+ *
+ *  The same blurs and edge filters the post-processing shaders apply
+ *  (see Lab10_FBOs/FBOFrag.glsl), for offline jobs with no GL context.
+ *
+ *  Every filter is split into a horizontal and a vertical pass. Rows are
+ *  filtered horizontally into a small ring buffer as they are needed, and
+ *  each output row is then combined vertically from the rows in the ring,
+ *  so only a handful of rows are ever held at once. Bands of rows are
+ *  processed on separate threads, and the inner loops run four floats
+ *  (or eight 16-bit values, on the 3x3 path) at a time with SSE2.
+ *
+ *  Pixels beyond the edges of the image repeat the nearest edge pixel.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include <vector>
+
+class PPM;
+
+namespace Convolution {
+    // A separable filter, given as the taps of its horizontal and vertical passes.
+    // Both must have an odd number of taps; the middle tap is centered on the pixel.
+    struct Kernel {
+        std::vector<float> horizontal;
+        std::vector<float> vertical;
+    };
+
+    // Gaussian blur with the given standard deviation in pixels, truncated at three deviations
+    Kernel gaussian(float sigma);
+
+    // The 3x3 Gaussian [1 2 1] x [1 2 1] / 16 used by the post-processing shader
+    Kernel gaussian3x3();
+
+    // Box blur averaging every pixel within radius pixels horizontally and vertically
+    Kernel box(int radius);
+
+    // Filters the image in place with the given kernel, using the given number of
+    // threads or one per hardware thread if zero. The 3x3 Gaussian takes an
+    // integer fast path.
+    void apply(PPM& image, const Kernel& kernel, unsigned int numThreads = 0);
+
+    // Replaces every component with the magnitude of its Sobel gradient
+    void sobel(PPM& image, unsigned int numThreads = 0);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/** @file MappedFile.h
+ *  @brief Private, copy-on-write view of a file mapped into memory
+ *
+ *  Maps an entire file into the address space of the process so that its
+ *  contents can be parsed in place without first being copied out of the
+ *  page cache.
+ *
+ *  The mapping is private and copy-on-write: writes through data() are
+ *  visible only to this process, and the operating system copies just the
+ *  pages that are actually written. The file on disk is never modified.
+ *
+ *  The file must not be truncated while it is mapped: the pages past its
+ *  new end are dropped, written ones included, and touching them raises
+ *  SIGBUS. Replace the file with a new one instead, which leaves the
+ *  mapping reading from the old one.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+public:
+    // Constructor creates an empty, unmapped view
+    MappedFile();
+
+    // Destructor unmaps the file if it is still mapped
+    ~MappedFile();
+
+    // A mapping has exactly one owner
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the whole of the given file, returning false if it cannot be opened,
+    // is empty, or cannot be mapped
+    bool open(const std::string& fileName);
+
+    // Unmaps the file, invalidating any pointers into it
+    void close();
+
+    // Returns whether a file is currently mapped
+    inline bool isOpen() const { return m_data != nullptr; }
+
+    // Returns the first byte of the mapped file
+    inline char* data() { return m_data; }
+
+    // Returns the size of the mapped file in bytes
+    inline std::size_t size() const { return m_size; }
+
+private:
+    char* m_data{nullptr};
+    std::size_t m_size{0};
+
+#ifdef _WIN32
+    // Windows keeps the file and mapping object open for the life of the view
+    void* m_fileHandle{nullptr};
+    void* m_mappingHandle{nullptr};
+#endif
+};
+
+#endif
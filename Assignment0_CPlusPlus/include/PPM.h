@@ -1,7 +1,7 @@
 /** @file PPM.h
  *  @brief Class for working with PPM images
- *  
- *  Class for working with P3 PPM images specifically.
+ *
+ *  Class for working with P3 (ASCII) and P6 (binary) PPM images.
  *
  *  @author Simon Kay
  *  @bug No known bugs.
@@ -9,19 +9,41 @@
 #ifndef PPM_H
 #define PPM_H
 
+#include <cstddef>
+#include <iosfwd>
 #include <string>
-#include <vector>
+
+#include "MappedFile.h"
+
+class PPMPipeline;
 
 class PPM {
 public:
+    // How the constructor brings the file into memory.
+    //
+    // Stream reads the file through a small fixed buffer into memory owned
+    // by the PPM. Mapped maps the file instead: P6 pixel data is then used
+    // directly from the mapping and only the pages later modified by
+    // setPixel or darken are copied, while P3 is parsed in place out of
+    // the mapped bytes. Parallel behaves like Mapped, but splits P3 parsing
+    // across every hardware thread.
+    enum class LoadMode { Stream, Mapped, Parallel };
+
     // Constructor loads a filename with the .ppm extension
-    PPM(std::string fileName);
+    PPM(std::string fileName, LoadMode mode = LoadMode::Stream);
 
     // Destructor clears any memory that has been allocated
     ~PPM();
 
-    // Saves a PPM Image to a new file.
-    void savePPM(std::string outputFileName);
+    // Pixel storage has a single owner
+    PPM(const PPM&) = delete;
+    PPM& operator=(const PPM&) = delete;
+
+    // Encoding used when saving: P3 writes ASCII text, P6 writes binary bytes
+    enum class Format { P3, P6 };
+
+    // Saves a PPM Image to a new file, returning whether it was written.
+    bool savePPM(std::string outputFileName, Format format = Format::P3);
 
     // Darken subtracts 50 from each of the red, green
     // and blue color components of all of the pixels
@@ -29,7 +51,11 @@ public:
     // 0 in a ppm.
     void darken();
 
-    // Sets a pixel to a specific R,G,B value 
+    // Starts recording a chain of operations that are applied together in a
+    // single pass over the image. See PPMPipeline.h.
+    PPMPipeline ops();
+
+    // Sets a pixel to a specific R,G,B value
     void setPixel(int x, int y, int R, int G, int B);
 
     // Returns the raw pixel data in an array.
@@ -42,46 +68,78 @@ public:
     // Returns image height
     inline int getHeight() { return m_height; }
 
-private:    
+private:
     // Store the raw pixel data here
     // Data is R,G,B format
-    unsigned char* m_PixelData;
+    unsigned char* m_PixelData{nullptr};
 
     // Store width and height of image.
     int m_width{0};
     int m_height{0};
     int m_maxVal{0};
 
-    // Verifies that the given line specifies the correct P3 format of PPM files
-    bool checkVersion(std::string line);
+    // Holds the file while the pixel data is being used from it in place
+    MappedFile m_mapping;
+
+    // Verifies that the given magic number is one of the supported P3 or P6 formats,
+    // returning true if the pixel data that follows is binary
+    bool checkVersion(std::string magic);
+
+    // Streams the file through a fixed-size read buffer into freshly allocated pixel storage
+    void loadStreamed(const std::string& fileName);
+
+    // Maps the file into memory and decodes it from there, optionally on several threads
+    void loadMapped(const std::string& fileName, bool parallel);
+
+    // Frees the pixel storage, unless it lives inside the file mapping
+    void releasePixels();
+
+    // Reads the width, height and maximum pixel value from the header
+    void readHeader(std::istream& in);
+
+    // Reads the width, height and maximum pixel value from a header held in memory
+    void readHeader(const char*& cursor, const char* end);
+
+    // Verifies that the maximum pixel value fits into a single byte per component
+    void checkMaxVal();
+
+    // Returns the number of bytes of pixel data the header describes
+    std::size_t dataSize() const;
+
+    // Verifies that the pixel data the header describes can be counted, and
+    // could fit in the given number of bytes left in the file
+    void checkDataSize(unsigned long long available, bool binary);
+
+    // Reads the next whitespace-delimited token of the header, skipping any comments
+    std::string readHeaderToken(std::istream& in);
 
-    // Gets the dimensions of the image from the given line
-    void getDims(std::string line);
+    // Reads the next whitespace-delimited token of a header held in memory, advancing
+    // the cursor past the token and the whitespace character that terminates it
+    std::string readHeaderToken(const char*& cursor, const char* end);
 
-    // Parses the given line for valid pixel values
-    std::vector<int> getImageLine(std::string line);
+    // Converts a header token to a non-negative integer
+    int parseHeaderValue(const std::string& token, const std::string& description);
 
-    // Gets the maximum pixel value of the image from the given line
-    void getMax(std::string line);
+    // Streams P3 ASCII pixel values straight into m_PixelData in a single pass
+    void readAsciiPixels(std::istream& in);
 
-    // Checks if the given line is a PPM comment (i.e. line starts with '#')
-    bool isComment(std::string line);
+    // Parses P3 ASCII pixel values in place from memory into m_PixelData
+    void parseAsciiPixels(const char* cursor, const char* end);
 
-    // Load the desired file into a vector of raw strings
-    std::vector<std::string> loadFile(std::string fileName);
+    // Parses P3 ASCII pixel values from memory on several threads at once
+    void parseAsciiPixelsParallel(const char* cursor, const char* end);
 
-    // Convert line strings into usable data
-    void processLines(std::vector<std::string> lineData);
+    // Validates a single parsed P3 value and stores it at the next free slot of m_PixelData
+    void storeAsciiValue(unsigned int& count, unsigned int value);
 
-    // Separates string into a vector of words
-    std::vector<std::string> separateWords(std::string line);
+    // Verifies that every pixel component was present in the file
+    void checkPixelCount(unsigned int count);
 
-    // With the given integer values from the file, populates the internal structure of this object to be
-    // usable
-    void setPixels(std::vector<int> numbers);
+    // Reads P6 binary pixel values straight into m_PixelData
+    void readBinaryPixels(std::istream& in);
 
-    // Converts the current state of this object to a string to be printed back out to a file
-    std::string toString();
+    // Writes the pixel data as P3 text through a fixed-size buffer
+    void writeAsciiPixels(std::ostream& out);
 
 };
 
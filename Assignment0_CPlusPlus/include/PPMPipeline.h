@@ -0,0 +1,91 @@
+/** @file PPMPipeline.h
+ *  @brief Lazily recorded chain of pixel operations on a PPM
+ *
+ *  Operations are recorded rather than run, and apply() then performs all of
+ *  them in a single pass over the image:
+ *
+ *      image.ops().darken(50).gamma(2.2f).invert().apply();
+ *
+ *  Consecutive operations that map each component independently (brightness,
+ *  contrast, gamma, invert) are folded into a single lookup table. Any
+ *  remaining stages are run one after the other on small tiles of the image
+ *  that stay in cache, so the image is only streamed through memory once.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+#ifndef PPMPIPELINE_H
+#define PPMPIPELINE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "PixelOps.h"
+
+class PPM;
+
+class PPMPipeline {
+public:
+    // Constructor records operations to be applied to the given image
+    PPMPipeline(PPM& image);
+
+    // Subtracts amount from every component, saturating at 0
+    PPMPipeline& darken(int amount);
+
+    // Adds delta to every component, saturating at 0 and 255
+    PPMPipeline& brightness(int delta);
+
+    // Scales every component's distance from mid-gray by factor
+    PPMPipeline& contrast(float factor);
+
+    // Applies gamma correction
+    PPMPipeline& gamma(float gamma);
+
+    // Replaces every component with 255 minus itself
+    PPMPipeline& invert();
+
+    // Reorders the channels of every pixel so that output channel c takes input channel order c
+    PPMPipeline& swizzle(int red, int green, int blue);
+
+    // Replaces every pixel with its luma
+    PPMPipeline& grayscale();
+
+    // Runs every recorded operation over the image in one pass, then clears the recording
+    void apply();
+
+private:
+    // What a single recorded operation does
+    enum class OpType { Brightness, Contrast, Gamma, Invert, Swizzle, Grayscale };
+
+    struct Op {
+        OpType type;
+        int amount;
+        float factor;
+        int order[3];
+    };
+
+    // One step of the fused pass: either a whole chain of per-component operations
+    // collapsed into a lookup table, or a single operation run as-is
+    struct Stage {
+        bool usesLut;
+        PixelOps::Lut lut;
+        Op op;
+    };
+
+    PPM& m_image;
+    std::vector<Op> m_ops;
+
+    // Adds an operation to the recording
+    PPMPipeline& record(OpType type, int amount, float factor);
+
+    // Returns whether an operation transforms each component independently of the others
+    static bool isPerComponent(OpType type);
+
+    // Runs a single operation over a range of pixel data
+    static void runOp(const Op& op, unsigned char* data, std::size_t size);
+
+    // Groups the recording into stages, folding per-component chains into lookup tables
+    std::vector<Stage> buildStages() const;
+};
+
+#endif
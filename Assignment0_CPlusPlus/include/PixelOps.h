@@ -0,0 +1,64 @@
+/** @file PixelOps.h
+ *  @brief In-place operations on interleaved 8-bit RGB pixel data
+ *
+ *  Each operation works on a buffer of R,G,B bytes such as the one returned
+ *  by PPM::pixelData(), and has a scalar implementation along with SSE2 and
+ *  AVX2 ones. The fastest implementation the processor supports is chosen at
+ *  runtime the first time any operation is used.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+#ifndef PIXELOPS_H
+#define PIXELOPS_H
+
+#include <cstddef>
+
+namespace PixelOps {
+    // A lookup table for applyLut. Alongside the bytes it keeps a copy widened to
+    // 32 bits for the AVX2 gather, so a table applied to many ranges of pixels is
+    // only widened once, by prepareLut.
+    struct Lut {
+        unsigned char bytes[256];
+        alignas(32) int wide[256];
+    };
+
+    // Adds delta to every component, saturating at 0 and 255
+    void brightness(unsigned char* data, std::size_t size, int delta);
+
+    // Scales every component's distance from mid-gray (128) by factor, saturating at 0 and 255.
+    // Factors are clamped to [0, 127].
+    void contrast(unsigned char* data, std::size_t size, float factor);
+
+    // Applies gamma correction, out = 255 * (in / 255) ^ (1 / gamma)
+    void gamma(unsigned char* data, std::size_t size, float gamma);
+
+    // Replaces every component with lut[component]
+    void applyLut(unsigned char* data, std::size_t size, const unsigned char lut[256]);
+
+    // Replaces every component with lut.bytes[component]. The table must have been
+    // prepared since its bytes were last changed.
+    void applyLut(unsigned char* data, std::size_t size, const Lut& lut);
+
+    // Fills in the widened copy of lut.bytes
+    void prepareLut(Lut& lut);
+
+    // Replaces every component with 255 minus itself
+    void invert(unsigned char* data, std::size_t size);
+
+    // Reorders the channels of every pixel, so that output channel c takes the value of input
+    // channel order[c]. For example {2, 1, 0} converts RGB to BGR.
+    void swizzle(unsigned char* data, std::size_t size, const int order[3]);
+
+    // Replaces every pixel with its Rec. 601 luma, (77R + 150G + 29B) / 256, in all three channels
+    void grayscale(unsigned char* data, std::size_t size);
+
+    // Builds the lookup table used by gamma
+    void buildGammaLut(float gamma, unsigned char lut[256]);
+
+    // Returns the name of the instruction set the operations were dispatched to:
+    // "avx2", "sse2" or "scalar"
+    const char* instructionSet();
+}
+
+#endif
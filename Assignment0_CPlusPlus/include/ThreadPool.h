@@ -0,0 +1,55 @@
+/** @file ThreadPool.h
+ *  @brief Fixed-size pool of worker threads
+ *
+ *  Tasks are queued with submit() and run in the order they were queued by
+ *  whichever worker is free first.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // Constructor starts the given number of workers, or one per hardware thread if zero
+    ThreadPool(unsigned int numThreads = 0);
+
+    // Destructor waits for every queued task to finish, then stops the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queues a task to be run on one of the workers. Tasks may submit further tasks.
+    void submit(std::function<void()> task);
+
+    // Blocks until the queue is empty and no task is running
+    void wait();
+
+    // Returns the number of workers
+    inline unsigned int size() const { return (unsigned int) m_workers.size(); }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    std::condition_variable m_idle;
+
+    unsigned int m_busy{0};
+    bool m_stopping{false};
+
+    // Runs queued tasks until the pool is stopped
+    void workerLoop();
+};
+
+#endif
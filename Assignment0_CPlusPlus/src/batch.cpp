@@ -0,0 +1,318 @@
+/** @file batch.cpp
+ *  @brief Applies a chain of operations to many PPM images at once.
+ *
+ *  Usage: PPMBatch <input directory or glob> <output directory>
+ *                  [--ops op[=value],...] [--threads N] [--p6]
+ *
+ *  Operations are applied in the order given. Runs of per-pixel operations
+ *  are fused into a single pass over each image (see PPMPipeline.h):
+ *
+ *      darken=N      subtract N from every component
+ *      brightness=N  add N (which may be negative) to every component
+ *      contrast=F    scale every component's distance from mid-gray by F
+ *      gamma=F       apply gamma correction
+ *      invert        replace every component with 255 minus itself
+ *      swizzle=RGB   reorder channels, e.g. swizzle=bgr
+ *      grayscale     replace every pixel with its luma
+ *
+ *  and the filters in between them each take a pass of their own (see
+ *  Convolution.h):
+ *
+ *      blur=F        Gaussian blur with a standard deviation of F pixels,
+ *                    or the 3x3 Gaussian if no value is given
+ *      box=N         box blur of radius N
+ *      sobel         Sobel edge magnitude
+ *
+ *  For example:
+ *
+ *      PPMBatch "../textures/test*.ppm" out --ops darken=50,gamma=2.2 --p6
+ *
+ *  Every image is read, decoded, processed and encoded, one step after
+ *  another, by a single task on a pool of worker threads. With N workers
+ *  up to N images are in flight at once, and memory use stays bounded
+ *  however many images there are.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Convolution.h"
+#include "PPM.h"
+#include "PPMPipeline.h"
+#include "ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+// A single operation parsed from the command line
+struct BatchOp {
+    std::string name;
+    std::string value;
+};
+
+// Totals gathered from every worker, in nanoseconds and bytes
+struct BatchStats {
+    std::atomic<long long> decodeTime{0};
+    std::atomic<long long> processTime{0};
+    std::atomic<long long> encodeTime{0};
+    std::atomic<unsigned long long> bytesIn{0};
+    std::atomic<unsigned long long> bytesOut{0};
+    std::atomic<unsigned int> succeeded{0};
+    std::atomic<unsigned int> failed{0};
+};
+
+// Returns whether a file name matches a pattern of literal characters, '*' and '?'
+static bool matchesWildcard(const std::string& name, const std::string& pattern) {
+    std::size_t nn = 0, pp = 0;
+    std::size_t starPattern = std::string::npos, starName = 0;
+
+    while (nn < name.size()) {
+        if (pp < pattern.size() && (pattern[pp] == '?' || pattern[pp] == name[nn])) {
+            ++nn;
+            ++pp;
+        } else if (pp < pattern.size() && pattern[pp] == '*') {
+            starPattern = pp++;
+            starName = nn;
+        } else if (starPattern != std::string::npos) {
+            pp = starPattern + 1;
+            nn = ++starName;
+        } else {
+            return false;
+        }
+    }
+
+    while (pp < pattern.size() && pattern[pp] == '*') {
+        ++pp;
+    }
+    return pp == pattern.size();
+}
+
+// Lists the files named by a directory (every .ppm inside it) or by a glob on file names
+static std::vector<fs::path> findInputs(const std::string& input) {
+    fs::path directory = input;
+    std::string pattern = "*.ppm";
+
+    if (!fs::is_directory(directory)) {
+        directory = fs::path(input).parent_path();
+        pattern = fs::path(input).filename().string();
+        if (directory.empty()) {
+            directory = ".";
+        }
+    }
+
+    std::vector<fs::path> files;
+    std::error_code error;
+    for (const fs::directory_entry& entry : fs::directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && matchesWildcard(entry.path().filename().string(), pattern)) {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    return files;
+}
+
+// Splits a comma-separated list of op[=value] entries, returning false if any is unknown
+static bool parseOps(const std::string& list, std::vector<BatchOp>& ops) {
+    static const char* known[] = {"darken", "brightness", "contrast", "gamma", "invert", "swizzle", "grayscale",
+                                  "blur", "box", "sobel"};
+
+    std::stringstream stream(list);
+    std::string item;
+    while (getline(stream, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+
+        BatchOp op;
+        std::size_t equals = item.find('=');
+        op.name = item.substr(0, equals);
+        op.value = equals == std::string::npos ? "" : item.substr(equals + 1);
+
+        if (std::find_if(std::begin(known), std::end(known),
+                         [&op](const char* name) { return op.name == name; }) == std::end(known)) {
+            std::cerr << "Unknown operation \"" << op.name << "\"." << std::endl;
+            return false;
+        }
+        if (op.name == "swizzle" && (op.value.size() != 3 || op.value.find_first_not_of("rgbRGB") != std::string::npos)) {
+            std::cerr << "swizzle expects three channel letters, e.g. swizzle=bgr." << std::endl;
+            return false;
+        }
+        ops.push_back(op);
+    }
+
+    return true;
+}
+
+// Applies the parsed operations to an image. Per-pixel operations are recorded
+// onto a pipeline, which is flushed whenever a filter needs the pixels.
+static void applyOps(PPM& image, const std::vector<BatchOp>& ops) {
+    PPMPipeline pipeline = image.ops();
+    for (const BatchOp& op : ops) {
+        // Every worker already has an image of its own, so filters run on one thread
+        if (op.name == "blur") {
+            pipeline.apply();
+            float sigma = (float) std::atof(op.value.c_str());
+            Convolution::apply(image, op.value.empty() ? Convolution::gaussian3x3() : Convolution::gaussian(sigma), 1);
+        } else if (op.name == "box") {
+            pipeline.apply();
+            Convolution::apply(image, Convolution::box(std::atoi(op.value.c_str())), 1);
+        } else if (op.name == "sobel") {
+            pipeline.apply();
+            Convolution::sobel(image, 1);
+        } else if (op.name == "darken") {
+            pipeline.darken(op.value.empty() ? 50 : std::atoi(op.value.c_str()));
+        } else if (op.name == "brightness") {
+            pipeline.brightness(std::atoi(op.value.c_str()));
+        } else if (op.name == "contrast") {
+            pipeline.contrast((float) std::atof(op.value.c_str()));
+        } else if (op.name == "gamma") {
+            pipeline.gamma((float) std::atof(op.value.c_str()));
+        } else if (op.name == "invert") {
+            pipeline.invert();
+        } else if (op.name == "swizzle") {
+            std::string channels = "rgb";
+            int order[3];
+            for (int ii = 0; ii < 3; ++ii) {
+                order[ii] = (int) channels.find((char) std::tolower(op.value[ii]));
+            }
+            pipeline.swizzle(order[0], order[1], order[2]);
+        } else if (op.name == "grayscale") {
+            pipeline.grayscale();
+        }
+    }
+    pipeline.apply();
+}
+
+// Returns the nanoseconds elapsed since the given time point
+static long long nanosecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Carries one image through every stage, recording how long each took
+static void processImage(const fs::path& input, const fs::path& output, const std::vector<BatchOp>& ops,
+                         PPM::Format format, BatchStats& stats) {
+    try {
+        auto start = std::chrono::steady_clock::now();
+        PPM image(input.string(), PPM::LoadMode::Mapped);
+        stats.decodeTime += nanosecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        applyOps(image, ops);
+        stats.processTime += nanosecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        bool saved = image.savePPM(output.string(), format);
+        stats.encodeTime += nanosecondsSince(start);
+        if (!saved) {
+            throw -1;
+        }
+
+        std::error_code error;
+        std::uintmax_t inputSize = fs::file_size(input, error);
+        if (!error) {
+            stats.bytesIn += inputSize;
+        }
+        std::uintmax_t outputSize = fs::file_size(output, error);
+        if (!error) {
+            stats.bytesOut += outputSize;
+        }
+        ++stats.succeeded;
+    } catch (...) {
+        std::cerr << "Failed to process " << input.string() << "." << std::endl;
+        ++stats.failed;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input directory or glob> <output directory>"
+                  << " [--ops op[=value],...] [--threads N] [--p6]" << std::endl;
+        return 1;
+    }
+
+    std::string input = argv[1];
+    fs::path outputDirectory = argv[2];
+    std::vector<BatchOp> ops;
+    unsigned int numThreads = 0;
+    PPM::Format format = PPM::Format::P3;
+
+    for (int ii = 3; ii < argc; ++ii) {
+        std::string arg = argv[ii];
+        if (arg == "--ops" && ii + 1 < argc) {
+            if (!parseOps(argv[++ii], ops)) {
+                return 1;
+            }
+        } else if (arg == "--threads" && ii + 1 < argc) {
+            numThreads = (unsigned int) std::max(0, std::atoi(argv[++ii]));
+        } else if (arg == "--p6") {
+            format = PPM::Format::P6;
+        } else {
+            std::cerr << "Unknown argument \"" << arg << "\"." << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<fs::path> inputs = findInputs(input);
+    if (inputs.empty()) {
+        std::cerr << "No input files match " << input << "." << std::endl;
+        return 1;
+    }
+
+    std::error_code error;
+    fs::create_directories(outputDirectory, error);
+    if (error) {
+        std::cerr << "Unable to create " << outputDirectory.string() << "." << std::endl;
+        return 1;
+    }
+
+    // Each image's pixels are read from its file while it is being processed,
+    // so an output must never be written over an input.
+    for (const fs::path& file : inputs) {
+        if (fs::equivalent(file.parent_path().empty() ? fs::path(".") : file.parent_path(), outputDirectory, error)) {
+            std::cerr << "The output directory " << outputDirectory.string()
+                      << " must not hold the input files." << std::endl;
+            return 1;
+        }
+    }
+
+    BatchStats stats;
+    auto start = std::chrono::steady_clock::now();
+    unsigned int workers = 0;
+    {
+        ThreadPool pool(numThreads);
+        workers = pool.size();
+        for (const fs::path& file : inputs) {
+            fs::path output = outputDirectory / file.filename();
+            pool.submit([file, output, &ops, format, &stats]() {
+                processImage(file, output, ops, format, stats);
+            });
+        }
+        pool.wait();
+    }
+    double seconds = nanosecondsSince(start) / 1e9;
+
+    double megabytesIn = stats.bytesIn / (1024.0 * 1024.0);
+    double megabytesOut = stats.bytesOut / (1024.0 * 1024.0);
+
+    std::printf("%u images (%u failed) on %u threads in %.3f s\n",
+                stats.succeeded.load(), stats.failed.load(), workers, seconds);
+    std::printf("  read %.1f MB, wrote %.1f MB\n", megabytesIn, megabytesOut);
+    std::printf("  %.1f images/s, %.1f MB/s in, %.1f MB/s out\n",
+                stats.succeeded / seconds, megabytesIn / seconds, megabytesOut / seconds);
+    std::printf("  worker time: decode %.1f ms, process %.1f ms, encode %.1f ms\n",
+                stats.decodeTime / 1e6, stats.processTime / 1e6, stats.encodeTime / 1e6);
+
+    return stats.failed == 0 ? 0 : 1;
+}
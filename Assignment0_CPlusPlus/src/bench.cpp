@@ -0,0 +1,78 @@
+/** @file bench.cpp
+ *  @brief Compares the load times of the PPM decoding paths.
+ *
+ *  Usage: PPMBench [runs] [file.ppm ...]
+ *
+ *  Each file is decoded with every PPM::LoadMode, and the fastest of the
+ *  given number of runs is reported along with the throughput it implies.
+ *  With no files, the textures shipped with this assignment are used.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PPM.h"
+
+// Returns the fastest time in milliseconds taken to load the file with the given mode
+static double timeLoad(const std::string& fileName, PPM::LoadMode mode, int runs) {
+    double best = 1e30;
+
+    for (int ii = 0; ii < runs; ++ii) {
+        auto start = std::chrono::steady_clock::now();
+        PPM image(fileName, mode);
+        auto stop = std::chrono::steady_clock::now();
+
+        best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+    }
+
+    return best;
+}
+
+int main(int argc, char** argv) {
+    int runs = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+
+    std::vector<std::string> files;
+    for (int ii = 2; ii < argc; ++ii) {
+        files.push_back(argv[ii]);
+    }
+    if (files.empty()) {
+        files.push_back("../textures/test.ppm");
+        files.push_back("../textures/test1.ppm");
+    }
+
+    const char* modeNames[] = {"stream", "mapped", "parallel"};
+    const PPM::LoadMode modes[] = {PPM::LoadMode::Stream, PPM::LoadMode::Mapped, PPM::LoadMode::Parallel};
+
+    std::printf("%u hardware threads, best of %d runs\n", std::thread::hardware_concurrency(), runs);
+    std::printf("%-40s %-10s %10s %10s %8s\n", "file", "mode", "ms", "MB/s", "speedup");
+
+    for (const std::string& fileName : files) {
+        std::error_code error;
+        std::uintmax_t fileSize = std::filesystem::file_size(fileName, error);
+        if (error) {
+            std::fprintf(stderr, "Unable to open %s.\n", fileName.c_str());
+            continue;
+        }
+        double megabytes = fileSize / (1024.0 * 1024.0);
+
+        double baseline = 0.0;
+        for (int ii = 0; ii < 3; ++ii) {
+            double ms = timeLoad(fileName, modes[ii], runs);
+            if (ii == 0) {
+                baseline = ms;
+            }
+            std::printf("%-40s %-10s %10.2f %10.1f %7.2fx\n", fileName.c_str(), modeNames[ii], ms,
+                        megabytes / (ms / 1000.0), baseline / ms);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#include "Convolution.h"
+#include "PPM.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONVOLUTION_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Fewest rows worth giving a thread of its own
+#define CONVOLUTION_MIN_BAND_HEIGHT 16
+
+//// ROW KERNELS:
+
+// out[i] += weight * in[i] for count floats
+static void multiplyAdd(float* out, const float* in, float weight, int count) {
+    int ii = 0;
+#ifdef CONVOLUTION_SSE2
+    const __m128 scale = _mm_set1_ps(weight);
+    for (; ii + 4 <= count; ii += 4) {
+        __m128 sum = _mm_add_ps(_mm_loadu_ps(out + ii), _mm_mul_ps(_mm_loadu_ps(in + ii), scale));
+        _mm_storeu_ps(out + ii, sum);
+    }
+#endif
+    for (; ii < count; ++ii) {
+        out[ii] += weight * in[ii];
+    }
+}
+
+// Rounds count floats to the nearest byte, saturating at 0 and 255
+static void storeBytes(const float* in, unsigned char* out, int count) {
+    int ii = 0;
+#ifdef CONVOLUTION_SSE2
+    for (; ii + 16 <= count; ii += 16) {
+        __m128i first = _mm_packs_epi32(_mm_cvtps_epi32(_mm_loadu_ps(in + ii)),
+                                        _mm_cvtps_epi32(_mm_loadu_ps(in + ii + 4)));
+        __m128i second = _mm_packs_epi32(_mm_cvtps_epi32(_mm_loadu_ps(in + ii + 8)),
+                                         _mm_cvtps_epi32(_mm_loadu_ps(in + ii + 12)));
+        _mm_storeu_si128((__m128i*) (out + ii), _mm_packus_epi16(first, second));
+    }
+#endif
+    for (; ii < count; ++ii) {
+        out[ii] = (unsigned char) std::min(255.0f, std::max(0.0f, std::nearbyint(in[ii])));
+    }
+}
+
+// Produces rows of an image filtered by a separable kernel, in increasing order
+//
+// Each source row is filtered horizontally once, into a ring buffer holding
+// as many rows as the vertical pass has taps. An output row is then the
+// weighted sum of the ring rows around it.
+class RowFilter {
+public:
+    RowFilter(const unsigned char* source, int width, int height, const Convolution::Kernel& kernel)
+        : m_source(source), m_width(width), m_height(height), m_kernel(kernel) {
+        const int rowSize = width * 3;
+        const int taps = (int) kernel.vertical.size();
+        m_horizontalRadius = (int) kernel.horizontal.size() / 2;
+
+        m_padded.resize((width + 2 * m_horizontalRadius) * 3);
+        m_ring.resize(taps * rowSize);
+        m_output.resize(rowSize);
+    }
+
+    // Returns the filtered floats of row y, valid until the next call
+    const float* row(int y) {
+        const int rowSize = this->m_width * 3;
+        const int taps = (int) this->m_kernel.vertical.size();
+        const int radius = taps / 2;
+
+        int first = std::max(this->m_loadedUpTo + 1, std::max(0, y - radius));
+        int last = std::min(this->m_height - 1, y + radius);
+        for (int source = first; source <= last; ++source) {
+            RowFilter::filterHorizontally(source, &this->m_ring[(source % taps) * rowSize]);
+        }
+        this->m_loadedUpTo = std::max(this->m_loadedUpTo, last);
+
+        std::fill(this->m_output.begin(), this->m_output.end(), 0.0f);
+        for (int tap = 0; tap < taps; ++tap) {
+            int source = std::min(this->m_height - 1, std::max(0, y - radius + tap));
+            multiplyAdd(this->m_output.data(), &this->m_ring[(source % taps) * rowSize],
+                        this->m_kernel.vertical[tap], rowSize);
+        }
+
+        return this->m_output.data();
+    }
+
+private:
+    const unsigned char* m_source;
+    int m_width;
+    int m_height;
+    const Convolution::Kernel& m_kernel;
+    int m_horizontalRadius;
+    int m_loadedUpTo{-1};
+
+    std::vector<float> m_padded;
+    std::vector<float> m_ring;
+    std::vector<float> m_output;
+
+    // Filters one source row horizontally into out
+    void filterHorizontally(int y, float* out) {
+        const unsigned char* row = this->m_source + (std::size_t) y * this->m_width * 3;
+        const int radius = this->m_horizontalRadius;
+
+        // Widen the row to floats, repeating the edge pixels into the padding
+        for (int x = -radius; x < this->m_width + radius; ++x) {
+            const unsigned char* pixel = row + std::min(this->m_width - 1, std::max(0, x)) * 3;
+            float* padded = &this->m_padded[(x + radius) * 3];
+            padded[0] = pixel[0];
+            padded[1] = pixel[1];
+            padded[2] = pixel[2];
+        }
+
+        // Neighbouring pixels are three floats apart, so every tap is one contiguous multiply-add
+        const int rowSize = this->m_width * 3;
+        std::fill(out, out + rowSize, 0.0f);
+        for (std::size_t tap = 0; tap < this->m_kernel.horizontal.size(); ++tap) {
+            multiplyAdd(out, &this->m_padded[tap * 3], this->m_kernel.horizontal[tap], rowSize);
+        }
+    }
+};
+
+// Runs band(y0, y1) over disjoint bands of rows covering the image, on several threads
+static void forEachBand(int height, unsigned int numThreads, const std::function<void(int, int)>& band) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    int numBands = std::max(1, std::min((int) numThreads, height / CONVOLUTION_MIN_BAND_HEIGHT));
+
+    std::vector<std::thread> workers;
+    for (int ii = 1; ii < numBands; ++ii) {
+        workers.emplace_back(band, height * ii / numBands, height * (ii + 1) / numBands);
+    }
+    band(0, height / numBands);
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// Returns whether a kernel is the 3x3 Gaussian the integer path handles
+static bool isGaussian3x3(const Convolution::Kernel& kernel) {
+    const float taps[3] = {0.25f, 0.5f, 0.25f};
+    return kernel.horizontal.size() == 3 && kernel.vertical.size() == 3 &&
+           std::equal(taps, taps + 3, kernel.horizontal.begin()) &&
+           std::equal(taps, taps + 3, kernel.vertical.begin());
+}
+
+// Filters one row with [1 2 1] into 16-bit sums, repeating the edge pixels
+static void binomialRow(const unsigned char* row, int width, unsigned short* out) {
+    const int rowSize = width * 3;
+    for (int c = 0; c < 3; ++c) {
+        // A single pixel is both edges at once, and is its own only neighbour
+        if (width == 1) {
+            out[c] = (unsigned short) (4 * row[c]);
+            continue;
+        }
+        out[c] = (unsigned short) (3 * row[c] + row[3 + c]);
+        int last = rowSize - 3 + c;
+        out[last] = (unsigned short) (row[last - 3] + 3 * row[last]);
+    }
+
+    int ii = 3;
+#ifdef CONVOLUTION_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; ii + 8 <= rowSize - 3; ii += 8) {
+        __m128i left = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) (row + ii - 3)), zero);
+        __m128i center = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) (row + ii)), zero);
+        __m128i right = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) (row + ii + 3)), zero);
+        __m128i sum = _mm_add_epi16(_mm_add_epi16(left, right), _mm_slli_epi16(center, 1));
+        _mm_storeu_si128((__m128i*) (out + ii), sum);
+    }
+#endif
+    for (; ii < rowSize - 3; ++ii) {
+        out[ii] = (unsigned short) (row[ii - 3] + 2 * row[ii] + row[ii + 3]);
+    }
+}
+
+// The 3x3 Gaussian in 16-bit integers: horizontal sums of at most 1020,
+// vertical sums of at most 4080, then a rounding shift by four
+static void gaussian3x3Band(const unsigned char* source, unsigned char* target, int width, int height, int y0, int y1) {
+    const int rowSize = width * 3;
+    std::vector<unsigned short> ring(3 * rowSize);
+    int loadedUpTo = -1;
+
+    for (int y = y0; y < y1; ++y) {
+        for (int row = std::max(loadedUpTo + 1, std::max(0, y - 1)); row <= std::min(height - 1, y + 1); ++row) {
+            binomialRow(source + (std::size_t) row * rowSize, width, &ring[(row % 3) * rowSize]);
+            loadedUpTo = row;
+        }
+
+        const unsigned short* above = &ring[(std::max(0, y - 1) % 3) * rowSize];
+        const unsigned short* center = &ring[(y % 3) * rowSize];
+        const unsigned short* below = &ring[(std::min(height - 1, y + 1) % 3) * rowSize];
+        unsigned char* out = target + (std::size_t) y * rowSize;
+
+        int ii = 0;
+#ifdef CONVOLUTION_SSE2
+        const __m128i rounding = _mm_set1_epi16(8);
+        for (; ii + 8 <= rowSize; ii += 8) {
+            __m128i sum = _mm_add_epi16(_mm_loadu_si128((const __m128i*) (above + ii)),
+                                        _mm_loadu_si128((const __m128i*) (below + ii)));
+            sum = _mm_add_epi16(sum, _mm_slli_epi16(_mm_loadu_si128((const __m128i*) (center + ii)), 1));
+            sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 4);
+            _mm_storel_epi64((__m128i*) (out + ii), _mm_packus_epi16(sum, sum));
+        }
+#endif
+        for (; ii < rowSize; ++ii) {
+            out[ii] = (unsigned char) ((above[ii] + 2 * center[ii] + below[ii] + 8) >> 4);
+        }
+    }
+}
+
+// Returns whether a kernel has an odd, non-zero number of taps in both directions
+static bool isValidKernel(const Convolution::Kernel& kernel) {
+    return kernel.horizontal.size() % 2 == 1 && kernel.vertical.size() % 2 == 1;
+}
+
+//// PUBLIC:
+
+// Gaussian blur with the given standard deviation in pixels, truncated at three deviations
+Convolution::Kernel Convolution::gaussian(float sigma) {
+    sigma = std::max(sigma, 0.01f);
+    int radius = std::max(1, (int) std::ceil(3.0f * sigma));
+
+    std::vector<float> taps(2 * radius + 1);
+    float sum = 0.0f;
+    for (int ii = -radius; ii <= radius; ++ii) {
+        taps[ii + radius] = std::exp(-(ii * ii) / (2.0f * sigma * sigma));
+        sum += taps[ii + radius];
+    }
+    for (float& tap : taps) {
+        tap /= sum;
+    }
+
+    return Kernel{taps, taps};
+}
+
+// The 3x3 Gaussian [1 2 1] x [1 2 1] / 16 used by the post-processing shader
+Convolution::Kernel Convolution::gaussian3x3() {
+    std::vector<float> taps = {0.25f, 0.5f, 0.25f};
+    return Kernel{taps, taps};
+}
+
+// Box blur averaging every pixel within radius pixels horizontally and vertically
+Convolution::Kernel Convolution::box(int radius) {
+    radius = std::max(0, radius);
+    std::vector<float> taps(2 * radius + 1, 1.0f / (2 * radius + 1));
+    return Kernel{taps, taps};
+}
+
+// Filters the image in place with the given kernel, using the given number of
+// threads or one per hardware thread if zero. The 3x3 Gaussian takes an
+// integer fast path.
+void Convolution::apply(PPM& image, const Kernel& kernel, unsigned int numThreads) {
+    unsigned char* data = image.pixelData();
+    if (!data) {
+        std::cerr << "PPM data improperly loaded, cannot filter." << std::endl;
+        return;
+    }
+    if (!isValidKernel(kernel)) {
+        std::cerr << "Convolution kernels must have an odd number of taps." << std::endl;
+        return;
+    }
+
+    const int width = image.getWidth();
+    const int height = image.getHeight();
+    const std::size_t size = (std::size_t) width * height * 3;
+
+    // Every band reads rows beyond its own edges, so results go to a separate buffer
+    std::vector<unsigned char> source(data, data + size);
+
+    if (isGaussian3x3(kernel)) {
+        forEachBand(height, numThreads, [&](int y0, int y1) {
+            gaussian3x3Band(source.data(), data, width, height, y0, y1);
+        });
+        return;
+    }
+
+    forEachBand(height, numThreads, [&](int y0, int y1) {
+        RowFilter filter(source.data(), width, height, kernel);
+        for (int y = y0; y < y1; ++y) {
+            storeBytes(filter.row(y), data + (std::size_t) y * width * 3, width * 3);
+        }
+    });
+}
+
+// Replaces every component with the magnitude of its Sobel gradient
+void Convolution::sobel(PPM& image, unsigned int numThreads) {
+    unsigned char* data = image.pixelData();
+    if (!data) {
+        std::cerr << "PPM data improperly loaded, cannot filter." << std::endl;
+        return;
+    }
+
+    const int width = image.getWidth();
+    const int height = image.getHeight();
+    const std::size_t size = (std::size_t) width * height * 3;
+    std::vector<unsigned char> source(data, data + size);
+
+    // Smooth across the gradient, difference along it
+    const Kernel gradientX{{-1.0f, 0.0f, 1.0f}, {1.0f, 2.0f, 1.0f}};
+    const Kernel gradientY{{1.0f, 2.0f, 1.0f}, {-1.0f, 0.0f, 1.0f}};
+
+    forEachBand(height, numThreads, [&](int y0, int y1) {
+        RowFilter filterX(source.data(), width, height, gradientX);
+        RowFilter filterY(source.data(), width, height, gradientY);
+        std::vector<float> magnitude(width * 3);
+
+        for (int y = y0; y < y1; ++y) {
+            const float* gx = filterX.row(y);
+            const float* gy = filterY.row(y);
+            for (int ii = 0; ii < width * 3; ++ii) {
+                magnitude[ii] = std::sqrt(gx[ii] * gx[ii] + gy[ii] * gy[ii]);
+            }
+            storeBytes(magnitude.data(), data + (std::size_t) y * width * 3, width * 3);
+        }
+    });
+}
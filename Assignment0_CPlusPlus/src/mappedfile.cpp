@@ -0,0 +1,105 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//// PUBLIC:
+
+// Constructor creates an empty, unmapped view
+MappedFile::MappedFile() {
+}
+
+// Destructor unmaps the file if it is still mapped
+MappedFile::~MappedFile() {
+    MappedFile::close();
+}
+
+// Maps the whole of the given file, returning false if it cannot be opened,
+// is empty, or cannot be mapped
+bool MappedFile::open(const std::string& fileName) {
+    MappedFile::close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    // PAGE_WRITECOPY/FILE_MAP_COPY give the same private copy-on-write view as MAP_PRIVATE
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    this->m_fileHandle = file;
+    this->m_mappingHandle = mapping;
+    this->m_data = static_cast<char*>(view);
+    this->m_size = (std::size_t) fileSize.QuadPart;
+#else
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, (std::size_t) fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+    this->m_data = static_cast<char*>(view);
+    this->m_size = (std::size_t) fileStat.st_size;
+#endif
+
+    return true;
+}
+
+// Unmaps the file, invalidating any pointers into it
+void MappedFile::close() {
+    if (!this->m_data) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(this->m_data);
+    CloseHandle(this->m_mappingHandle);
+    CloseHandle(this->m_fileHandle);
+    this->m_mappingHandle = nullptr;
+    this->m_fileHandle = nullptr;
+#else
+    munmap(this->m_data, this->m_size);
+#endif
+
+    this->m_data = nullptr;
+    this->m_size = 0;
+}
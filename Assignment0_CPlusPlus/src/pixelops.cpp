@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "PixelOps.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PIXELOPS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2 instructions inside functions that ask for them,
+// which keeps the rest of the program runnable on older processors. MSVC
+// accepts the intrinsics anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+#define PIXELOPS_AVX2 __attribute__((target("avx2")))
+#else
+#define PIXELOPS_AVX2
+#endif
+
+//// SCALAR:
+
+static void brightnessScalar(unsigned char* data, std::size_t size, int delta) {
+    for (std::size_t ii = 0; ii < size; ++ii) {
+        data[ii] = (unsigned char) std::min(255, std::max(0, data[ii] + delta));
+    }
+}
+
+static void contrastScalar(unsigned char* data, std::size_t size, int factor) {
+    for (std::size_t ii = 0; ii < size; ++ii) {
+        int value = (((data[ii] - 128) * factor) >> 8) + 128;
+        data[ii] = (unsigned char) std::min(255, std::max(0, value));
+    }
+}
+
+static void applyLutScalar(unsigned char* data, std::size_t size, const PixelOps::Lut& table) {
+    const unsigned char* lut = table.bytes;
+    std::size_t ii = 0;
+    for (; ii + 4 <= size; ii += 4) {
+        unsigned char a = lut[data[ii]];
+        unsigned char b = lut[data[ii + 1]];
+        unsigned char c = lut[data[ii + 2]];
+        unsigned char d = lut[data[ii + 3]];
+        data[ii] = a;
+        data[ii + 1] = b;
+        data[ii + 2] = c;
+        data[ii + 3] = d;
+    }
+    for (; ii < size; ++ii) {
+        data[ii] = lut[data[ii]];
+    }
+}
+
+static void invertScalar(unsigned char* data, std::size_t size) {
+    for (std::size_t ii = 0; ii < size; ++ii) {
+        data[ii] = 255 - data[ii];
+    }
+}
+
+static void swizzleScalar(unsigned char* data, std::size_t size, const int order[3]) {
+    for (std::size_t ii = 0; ii + 3 <= size; ii += 3) {
+        unsigned char pixel[3] = {data[ii], data[ii + 1], data[ii + 2]};
+        data[ii] = pixel[order[0]];
+        data[ii + 1] = pixel[order[1]];
+        data[ii + 2] = pixel[order[2]];
+    }
+}
+
+static void grayscaleScalar(unsigned char* data, std::size_t size) {
+    for (std::size_t ii = 0; ii + 3 <= size; ii += 3) {
+        unsigned char luma = (unsigned char) ((77 * data[ii] + 150 * data[ii + 1] + 29 * data[ii + 2] + 128) >> 8);
+        data[ii] = luma;
+        data[ii + 1] = luma;
+        data[ii + 2] = luma;
+    }
+}
+
+#ifdef PIXELOPS_X86
+
+//// SSE2:
+//
+// SSE2 has no byte shuffle or gather, so the lookup table, swizzle and
+// grayscale operations keep the scalar implementations at this level.
+
+static void brightnessSse2(unsigned char* data, std::size_t size, int delta) {
+    const __m128i amount = _mm_set1_epi8((char) std::min(255, std::abs(delta)));
+    std::size_t ii = 0;
+    for (; ii + 16 <= size; ii += 16) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*) (data + ii));
+        pixels = delta >= 0 ? _mm_adds_epu8(pixels, amount) : _mm_subs_epu8(pixels, amount);
+        _mm_storeu_si128((__m128i*) (data + ii), pixels);
+    }
+    brightnessScalar(data + ii, size - ii, delta);
+}
+
+// Scales eight signed 16-bit distances from mid-gray by the 8.8 fixed-point factor
+static __m128i scaleFromMidGraySse2(__m128i distance, __m128i factor) {
+    __m128i low = _mm_mullo_epi16(distance, factor);
+    __m128i high = _mm_mulhi_epi16(distance, factor);
+    __m128i first = _mm_srai_epi32(_mm_unpacklo_epi16(low, high), 8);
+    __m128i second = _mm_srai_epi32(_mm_unpackhi_epi16(low, high), 8);
+    return _mm_adds_epi16(_mm_packs_epi32(first, second), _mm_set1_epi16(128));
+}
+
+static void contrastSse2(unsigned char* data, std::size_t size, int factor) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i midGray = _mm_set1_epi16(128);
+    const __m128i scale = _mm_set1_epi16((short) factor);
+    std::size_t ii = 0;
+    for (; ii + 16 <= size; ii += 16) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*) (data + ii));
+        __m128i low = _mm_sub_epi16(_mm_unpacklo_epi8(pixels, zero), midGray);
+        __m128i high = _mm_sub_epi16(_mm_unpackhi_epi8(pixels, zero), midGray);
+        pixels = _mm_packus_epi16(scaleFromMidGraySse2(low, scale), scaleFromMidGraySse2(high, scale));
+        _mm_storeu_si128((__m128i*) (data + ii), pixels);
+    }
+    contrastScalar(data + ii, size - ii, factor);
+}
+
+static void invertSse2(unsigned char* data, std::size_t size) {
+    const __m128i ones = _mm_set1_epi8((char) 0xFF);
+    std::size_t ii = 0;
+    for (; ii + 16 <= size; ii += 16) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*) (data + ii));
+        _mm_storeu_si128((__m128i*) (data + ii), _mm_xor_si128(pixels, ones));
+    }
+    invertScalar(data + ii, size - ii);
+}
+
+//// AVX2:
+
+PIXELOPS_AVX2 static void brightnessAvx2(unsigned char* data, std::size_t size, int delta) {
+    const __m256i amount = _mm256_set1_epi8((char) std::min(255, std::abs(delta)));
+    std::size_t ii = 0;
+    for (; ii + 32 <= size; ii += 32) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i*) (data + ii));
+        pixels = delta >= 0 ? _mm256_adds_epu8(pixels, amount) : _mm256_subs_epu8(pixels, amount);
+        _mm256_storeu_si256((__m256i*) (data + ii), pixels);
+    }
+    brightnessScalar(data + ii, size - ii, delta);
+}
+
+// Scales sixteen signed 16-bit distances from mid-gray by the 8.8 fixed-point factor
+PIXELOPS_AVX2 static __m256i scaleFromMidGrayAvx2(__m256i distance, __m256i factor) {
+    __m256i low = _mm256_mullo_epi16(distance, factor);
+    __m256i high = _mm256_mulhi_epi16(distance, factor);
+    __m256i first = _mm256_srai_epi32(_mm256_unpacklo_epi16(low, high), 8);
+    __m256i second = _mm256_srai_epi32(_mm256_unpackhi_epi16(low, high), 8);
+    return _mm256_adds_epi16(_mm256_packs_epi32(first, second), _mm256_set1_epi16(128));
+}
+
+// The unpacks and packs below both work within 128-bit lanes, so their
+// reorderings cancel out and no cross-lane permute is needed.
+PIXELOPS_AVX2 static void contrastAvx2(unsigned char* data, std::size_t size, int factor) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i midGray = _mm256_set1_epi16(128);
+    const __m256i scale = _mm256_set1_epi16((short) factor);
+    std::size_t ii = 0;
+    for (; ii + 32 <= size; ii += 32) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i*) (data + ii));
+        __m256i low = _mm256_sub_epi16(_mm256_unpacklo_epi8(pixels, zero), midGray);
+        __m256i high = _mm256_sub_epi16(_mm256_unpackhi_epi8(pixels, zero), midGray);
+        pixels = _mm256_packus_epi16(scaleFromMidGrayAvx2(low, scale), scaleFromMidGrayAvx2(high, scale));
+        _mm256_storeu_si256((__m256i*) (data + ii), pixels);
+    }
+    contrastScalar(data + ii, size - ii, factor);
+}
+
+// Looks up eight bytes at a time with a gather from the table widened to 32 bits
+PIXELOPS_AVX2 static void applyLutAvx2(unsigned char* data, std::size_t size, const PixelOps::Lut& lut) {
+    const __m256i packOrder = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                               0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i laneOrder = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+    std::size_t ii = 0;
+    for (; ii + 8 <= size; ii += 8) {
+        __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) (data + ii)));
+        __m256i values = _mm256_i32gather_epi32(lut.wide, indices, 4);
+        values = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(values, packOrder), laneOrder);
+        _mm_storel_epi64((__m128i*) (data + ii), _mm256_castsi256_si128(values));
+    }
+    applyLutScalar(data + ii, size - ii, lut);
+}
+
+PIXELOPS_AVX2 static void invertAvx2(unsigned char* data, std::size_t size) {
+    const __m256i ones = _mm256_set1_epi8((char) 0xFF);
+    std::size_t ii = 0;
+    for (; ii + 32 <= size; ii += 32) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i*) (data + ii));
+        _mm256_storeu_si256((__m256i*) (data + ii), _mm256_xor_si256(pixels, ones));
+    }
+    invertScalar(data + ii, size - ii);
+}
+
+// The pixel operations below work on five pixels (15 bytes) per 16-byte load,
+// since a pixel never straddles the window. The sixteenth byte is written back
+// unchanged before the next window picks it up as its first byte.
+
+PIXELOPS_AVX2 static void swizzleAvx2(unsigned char* data, std::size_t size, const int order[3]) {
+    alignas(16) char shuffle[16];
+    for (int pixel = 0; pixel < 5; ++pixel) {
+        for (int channel = 0; channel < 3; ++channel) {
+            shuffle[pixel * 3 + channel] = (char) (pixel * 3 + order[channel]);
+        }
+    }
+    shuffle[15] = 15;
+    const __m128i mask = _mm_load_si128((const __m128i*) shuffle);
+
+    std::size_t ii = 0;
+    for (; ii + 16 <= size; ii += 15) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*) (data + ii));
+        _mm_storeu_si128((__m128i*) (data + ii), _mm_shuffle_epi8(pixels, mask));
+    }
+    swizzleScalar(data + ii, size - ii, order);
+}
+
+PIXELOPS_AVX2 static void grayscaleAvx2(unsigned char* data, std::size_t size) {
+    const __m128i reds = _mm_setr_epi8(0, -1, 3, -1, 6, -1, 9, -1, 12, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i greens = _mm_setr_epi8(1, -1, 4, -1, 7, -1, 10, -1, 13, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i blues = _mm_setr_epi8(2, -1, 5, -1, 8, -1, 11, -1, 14, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i spread = _mm_setr_epi8(0, 0, 0, 2, 2, 2, 4, 4, 4, 6, 6, 6, 8, 8, 8, -1);
+    const __m128i lastByte = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1);
+    const __m128i redWeight = _mm_set1_epi16(77);
+    const __m128i greenWeight = _mm_set1_epi16(150);
+    const __m128i blueWeight = _mm_set1_epi16(29);
+    const __m128i rounding = _mm_set1_epi16(128);
+
+    std::size_t ii = 0;
+    for (; ii + 16 <= size; ii += 15) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*) (data + ii));
+        __m128i luma = _mm_add_epi16(_mm_mullo_epi16(_mm_shuffle_epi8(pixels, reds), redWeight),
+                                     _mm_mullo_epi16(_mm_shuffle_epi8(pixels, greens), greenWeight));
+        luma = _mm_add_epi16(luma, _mm_mullo_epi16(_mm_shuffle_epi8(pixels, blues), blueWeight));
+        luma = _mm_srli_epi16(_mm_add_epi16(luma, rounding), 8);
+        __m128i result = _mm_or_si128(_mm_shuffle_epi8(luma, spread), _mm_and_si128(pixels, lastByte));
+        _mm_storeu_si128((__m128i*) (data + ii), result);
+    }
+    grayscaleScalar(data + ii, size - ii);
+}
+
+#endif
+
+//// DISPATCH:
+
+// One implementation of every operation, all for the same instruction set
+struct KernelTable {
+    const char* name;
+    void (*brightness)(unsigned char*, std::size_t, int);
+    void (*contrast)(unsigned char*, std::size_t, int);
+    void (*applyLut)(unsigned char*, std::size_t, const PixelOps::Lut&);
+    void (*invert)(unsigned char*, std::size_t);
+    void (*swizzle)(unsigned char*, std::size_t, const int*);
+    void (*grayscale)(unsigned char*, std::size_t);
+};
+
+// Queries the processor for the best supported table of kernels
+static KernelTable selectKernels() {
+    KernelTable scalar = {"scalar", brightnessScalar, contrastScalar, applyLutScalar,
+                          invertScalar, swizzleScalar, grayscaleScalar};
+
+#ifdef PIXELOPS_X86
+    KernelTable sse2 = {"sse2", brightnessSse2, contrastSse2, applyLutScalar,
+                        invertSse2, swizzleScalar, grayscaleScalar};
+    KernelTable avx2 = {"avx2", brightnessAvx2, contrastAvx2, applyLutAvx2,
+                        invertAvx2, swizzleAvx2, grayscaleAvx2};
+
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    bool hasAvx2 = __builtin_cpu_supports("avx2");
+    bool hasSse2 = __builtin_cpu_supports("sse2");
+#else
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool hasSse2 = (info[3] & (1 << 26)) != 0;
+    // AVX2 also needs the operating system to save the YMM registers
+    bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    bool hasAvx2 = false;
+    if (maxLeaf >= 7 && osSavesYmm) {
+        __cpuidex(info, 7, 0);
+        hasAvx2 = (info[1] & (1 << 5)) != 0;
+    }
+#endif
+
+    if (hasAvx2) {
+        return avx2;
+    }
+    if (hasSse2) {
+        return sse2;
+    }
+#endif
+
+    return scalar;
+}
+
+// Returns the kernels for this processor, selecting them on first use
+static const KernelTable& kernels() {
+    static const KernelTable table = selectKernels();
+    return table;
+}
+
+//// PUBLIC:
+
+// Adds delta to every component, saturating at 0 and 255
+void PixelOps::brightness(unsigned char* data, std::size_t size, int delta) {
+    kernels().brightness(data, size, std::min(255, std::max(-255, delta)));
+}
+
+// Scales every component's distance from mid-gray (128) by factor, saturating at 0 and 255.
+// Factors are clamped to [0, 127].
+void PixelOps::contrast(unsigned char* data, std::size_t size, float factor) {
+    // 8.8 fixed point, which keeps the factor within a signed 16-bit lane
+    int fixedFactor = (int) std::lround(std::min(127.0f, std::max(0.0f, factor)) * 256.0f);
+    kernels().contrast(data, size, std::min(32767, fixedFactor));
+}
+
+// Applies gamma correction, out = 255 * (in / 255) ^ (1 / gamma)
+void PixelOps::gamma(unsigned char* data, std::size_t size, float gamma) {
+    Lut lut;
+    PixelOps::buildGammaLut(gamma, lut.bytes);
+    PixelOps::prepareLut(lut);
+    kernels().applyLut(data, size, lut);
+}
+
+// Replaces every component with lut[component]
+void PixelOps::applyLut(unsigned char* data, std::size_t size, const unsigned char lut[256]) {
+    Lut table;
+    std::memcpy(table.bytes, lut, sizeof(table.bytes));
+    PixelOps::prepareLut(table);
+    kernels().applyLut(data, size, table);
+}
+
+// Replaces every component with lut.bytes[component]
+void PixelOps::applyLut(unsigned char* data, std::size_t size, const Lut& lut) {
+    kernels().applyLut(data, size, lut);
+}
+
+// Fills in the widened copy of lut.bytes
+void PixelOps::prepareLut(Lut& lut) {
+    for (int ii = 0; ii < 256; ++ii) {
+        lut.wide[ii] = lut.bytes[ii];
+    }
+}
+
+// Replaces every component with 255 minus itself
+void PixelOps::invert(unsigned char* data, std::size_t size) {
+    kernels().invert(data, size);
+}
+
+// Reorders the channels of every pixel, so that output channel c takes the value of input
+// channel order[c]. For example {2, 1, 0} converts RGB to BGR.
+void PixelOps::swizzle(unsigned char* data, std::size_t size, const int order[3]) {
+    int clamped[3];
+    for (int channel = 0; channel < 3; ++channel) {
+        clamped[channel] = std::min(2, std::max(0, order[channel]));
+    }
+    kernels().swizzle(data, size, clamped);
+}
+
+// Replaces every pixel with its Rec. 601 luma, (77R + 150G + 29B) / 256, in all three channels
+void PixelOps::grayscale(unsigned char* data, std::size_t size) {
+    kernels().grayscale(data, size);
+}
+
+// Builds the lookup table used by gamma
+void PixelOps::buildGammaLut(float gamma, unsigned char lut[256]) {
+    double exponent = 1.0 / std::max(0.01f, gamma);
+    for (int ii = 0; ii < 256; ++ii) {
+        lut[ii] = (unsigned char) std::lround(255.0 * std::pow(ii / 255.0, exponent));
+    }
+}
+
+// Returns the name of the instruction set the operations were dispatched to:
+// "avx2", "sse2" or "scalar"
+const char* PixelOps::instructionSet() {
+    return kernels().name;
+}
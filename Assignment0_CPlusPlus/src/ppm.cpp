@@ -1,33 +1,127 @@
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <thread>
+#include <vector>
 
 #include "PPM.h"
+#include "PPMPipeline.h"
+#include "PixelOps.h"
+
+// Size of the fixed buffer pixel data is streamed through while loading
+#define PPM_READ_BUFFER_SIZE (64 * 1024)
+
+// Size of the fixed buffer P3 text is assembled in while saving
+#define PPM_WRITE_BUFFER_SIZE (64 * 1024)
+
+// Smallest slice of P3 text worth handing to a thread of its own
+#define PPM_MIN_PARALLEL_CHUNK_SIZE (256 * 1024)
+
+// Counts the whitespace-separated integers in a slice of P3 text, returning
+// false if the slice contains anything else
+static bool countAsciiValues(const char* cursor, const char* end, unsigned int& count) {
+    bool inNumber = false;
+
+    for (; cursor < end; ++cursor) {
+        char c = *cursor;
+        if (c >= '0' && c <= '9') {
+            count += !inNumber;
+            inNumber = true;
+        } else if (std::isspace((unsigned char) c)) {
+            inNumber = false;
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Parses a slice of P3 text that countAsciiValues has already accepted into
+// consecutive bytes of out, returning false if a value exceeds maxVal
+static bool parseAsciiChunk(const char* cursor, const char* end, unsigned char* out, int maxVal) {
+    while (cursor < end) {
+        if (std::isspace((unsigned char) *cursor)) {
+            ++cursor;
+            continue;
+        }
+
+        unsigned int value = 0;
+        std::from_chars_result result = std::from_chars(cursor, end, value);
+        if (result.ec != std::errc() || value > (unsigned int) maxVal) {
+            return false;
+        }
+        *out++ = (unsigned char) value;
+        cursor = result.ptr;
+    }
+
+    return true;
+}
 
 //// PUBLIC:
 
 // Constructor loads a filename with the .ppm extension
-PPM::PPM(std::string fileName) {
-    std::vector<std::string> fileContents = PPM::loadFile(fileName);
-    PPM::processLines(fileContents);
+PPM::PPM(std::string fileName, LoadMode mode) {
+    if (mode == LoadMode::Mapped || mode == LoadMode::Parallel) {
+        PPM::loadMapped(fileName, mode == LoadMode::Parallel);
+    } else {
+        PPM::loadStreamed(fileName);
+    }
 }
 
 // Destructor clears any memory that has been allocated
 PPM::~PPM() {
-    delete[] this->m_PixelData;
+    PPM::releasePixels();
 }
 
-// Saves a PPM Image to a new file.
-void PPM::savePPM(std::string outputFileName) {
+// Saves a PPM Image to a new file, returning whether it was written.
+//
+// The image is written to a temporary file beside the target, which then
+// replaces it. Pixel data loaded with LoadMode::Mapped still reads from the
+// file it came from, and truncating that file to rewrite it in place would
+// pull the pixels out from under the write.
+bool PPM::savePPM(std::string outputFileName, Format format) {
     if (!this->m_PixelData) {
         std::cerr << "PPM data improperly loaded, cannot save." << std::endl;
-        return;
+        return false;
+    }
+
+    const std::string tempFileName = outputFileName + ".tmp";
+    std::ofstream outFile(tempFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        std::cerr << "Unable to open " << tempFileName << " for writing." << std::endl;
+        return false;
+    }
+
+    outFile << (format == Format::P6 ? "P6\n" : "P3\n")
+            << this->m_width << " " << this->m_height << "\n"
+            << this->m_maxVal << "\n";
+
+    if (format == Format::P6) {
+        outFile.write((const char*) this->m_PixelData, PPM::dataSize());
+    } else {
+        PPM::writeAsciiPixels(outFile);
     }
 
-    std::ofstream outFile;
-    outFile.open(outputFileName);
-    outFile << PPM::toString();
     outFile.close();
+    std::error_code error;
+    if (!outFile) {
+        std::cerr << "Failed to write " << outputFileName << "." << std::endl;
+    } else {
+        std::filesystem::rename(tempFileName, outputFileName, error);
+        if (!error) {
+            return true;
+        }
+        std::cerr << "Unable to replace " << outputFileName << ": " << error.message() << std::endl;
+    }
+    std::filesystem::remove(tempFileName, error);
+    return false;
 }
 
 // Darken subtracts 50 from each of the red, green
@@ -40,11 +134,13 @@ void PPM::darken() {
         return;
     }
 
-    unsigned int size = this->m_width * this->m_height * 3;
-    for (unsigned int ii = 0; ii < size; ++ii) {
-        this->m_PixelData[ii] = std::max(0, this->m_PixelData[ii] - 50);
-    }
-    return;
+    PixelOps::brightness(this->m_PixelData, PPM::dataSize(), -50);
+}
+
+// Starts recording a chain of operations that are applied together in a
+// single pass over the image
+PPMPipeline PPM::ops() {
+    return PPMPipeline(*this);
 }
 
 // Sets a pixel to a specific R,G,B value 
@@ -54,13 +150,13 @@ void PPM::setPixel(int x, int y, int R, int G, int B) {
         return;
     }
 
-    unsigned int redIndex = y * this->m_width * 3 + x * 3;
-
-    if (redIndex + 2 > (this->m_width * this->m_height * 3)) {
+    if (x < 0 || y < 0 || x >= this->m_width || y >= this->m_height) {
         std::cerr << "Cannot edit data at given indices; out of bounds." << std::endl;
         return;
     }
 
+    const std::size_t redIndex = ((std::size_t) y * this->m_width + x) * 3;
+
     this->m_PixelData[redIndex] = R;
     this->m_PixelData[redIndex + 1] = G;
     this->m_PixelData[redIndex + 2] = B;
@@ -68,182 +164,456 @@ void PPM::setPixel(int x, int y, int R, int G, int B) {
 
 //// PRIVATE:
 
-// Verifies that the given line specifies the correct P3 format of PPM files
-bool PPM::checkVersion(std::string line) {
-    if (line != "P3") {
-        std::cerr << "Only P3 .ppm files can be loaded." << std::endl;
-        throw -1;
+// Verifies that the given magic number is one of the supported P3 or P6 formats,
+// returning true if the pixel data that follows is binary
+bool PPM::checkVersion(std::string magic) {
+    if (magic == "P3") {
+        return false;
     }
-    return true;
+    if (magic == "P6") {
+        return true;
+    }
+    std::cerr << "Only P3 and P6 .ppm files can be loaded." << std::endl;
+    throw -1;
 }
 
-// Gets the dimensions of the image from the given line
-void PPM::getDims(std::string line) {
-    std::vector<std::string> words = PPM::separateWords(line);
+// Streams the file through a fixed-size read buffer into freshly allocated pixel storage
+void PPM::loadStreamed(const std::string& fileName) {
+    std::ifstream inFile(fileName, std::ios::in | std::ios::binary);
 
-    if (words.size() != 2) {
-        std::cerr << "Line specifying image dimensions must contain two integers." << std::endl;
+    if (!inFile.is_open()) {
+        std::cerr << "Unable to open " << fileName << "." << std::endl;
         throw -1;
     }
 
-    this->m_width = stoi(words[0]);
-    this->m_height = stoi(words[1]);
+    bool binary = PPM::checkVersion(PPM::readHeaderToken(inFile));
+    PPM::readHeader(inFile);
+
+    // Measure what is left of the file, when it can be seeked
+    unsigned long long available = ULLONG_MAX;
+    std::streampos start = inFile.tellg();
+    if (start != std::streampos(-1) && inFile.seekg(0, std::ios::end)) {
+        available = (unsigned long long) (inFile.tellg() - start);
+        inFile.seekg(start);
+    }
+    inFile.clear();
+    PPM::checkDataSize(available, binary);
+
+    this->m_PixelData = new unsigned char[PPM::dataSize()];
+
+    try {
+        if (binary) {
+            PPM::readBinaryPixels(inFile);
+        } else {
+            PPM::readAsciiPixels(inFile);
+        }
+    } catch (...) {
+        // The destructor does not run for a partially constructed object
+        PPM::releasePixels();
+        throw;
+    }
 }
 
-// Parses the given line for valid pixel values
-std::vector<int> PPM::getImageLine(std::string line) {
-    std::vector<std::string> words = PPM::separateWords(line);
-    std::vector<int> numbers;
+// Maps the file into memory. P6 pixel data is used in place; P3 is parsed
+// straight out of the mapping, which is then released.
+void PPM::loadMapped(const std::string& fileName, bool parallel) {
+    if (!this->m_mapping.open(fileName)) {
+        std::cerr << "Unable to map " << fileName << "." << std::endl;
+        throw -1;
+    }
+
+    const char* cursor = this->m_mapping.data();
+    const char* end = cursor + this->m_mapping.size();
+
+    bool binary = PPM::checkVersion(PPM::readHeaderToken(cursor, end));
+    PPM::readHeader(cursor, end);
+    PPM::checkDataSize(end - cursor, binary);
+
+    const std::size_t size = PPM::dataSize();
+
+    if (binary) {
+        // The mapping is copy-on-write, so setPixel and darken only copy the pages they touch
+        this->m_PixelData = (unsigned char*) this->m_mapping.data() + (cursor - this->m_mapping.data());
+        return;
+    }
+
+    this->m_PixelData = new unsigned char[size];
+
+    try {
+        if (parallel) {
+            PPM::parseAsciiPixelsParallel(cursor, end);
+        } else {
+            PPM::parseAsciiPixels(cursor, end);
+        }
+    } catch (...) {
+        PPM::releasePixels();
+        throw;
+    }
+
+    this->m_mapping.close();
+}
 
-    for (unsigned int ii = 0; ii < words.size(); ++ii) {
-        numbers.push_back(stoi(words[ii]));
+// Frees the pixel storage, unless it lives inside the file mapping
+void PPM::releasePixels() {
+    const unsigned char* mapped = (const unsigned char*) this->m_mapping.data();
+    bool inMapping = this->m_mapping.isOpen() && this->m_PixelData >= mapped &&
+                     this->m_PixelData < mapped + this->m_mapping.size();
+    if (!inMapping) {
+        delete[] this->m_PixelData;
     }
+    this->m_PixelData = nullptr;
+    this->m_mapping.close();
+}
 
-    return numbers;
+// Reads the width, height and maximum pixel value from the header
+void PPM::readHeader(std::istream& in) {
+    this->m_width = PPM::parseHeaderValue(PPM::readHeaderToken(in), "image width");
+    this->m_height = PPM::parseHeaderValue(PPM::readHeaderToken(in), "image height");
+    this->m_maxVal = PPM::parseHeaderValue(PPM::readHeaderToken(in), "maximum pixel value");
+    PPM::checkMaxVal();
 }
 
-// Gets the maximum pixel value of the image from the given line
-void PPM::getMax(std::string line) {
-    std::vector<std::string> words = PPM::separateWords(line);
+// Reads the width, height and maximum pixel value from a header held in memory
+void PPM::readHeader(const char*& cursor, const char* end) {
+    this->m_width = PPM::parseHeaderValue(PPM::readHeaderToken(cursor, end), "image width");
+    this->m_height = PPM::parseHeaderValue(PPM::readHeaderToken(cursor, end), "image height");
+    this->m_maxVal = PPM::parseHeaderValue(PPM::readHeaderToken(cursor, end), "maximum pixel value");
+    PPM::checkMaxVal();
+}
 
-    if (words.size() != 1) {
-        std::cerr << "Line specifying maximum pixel value must contain one integer." << std::endl;
+// Verifies that the maximum pixel value fits into a single byte per component
+void PPM::checkMaxVal() {
+    if (this->m_maxVal == 0 || this->m_maxVal > 255) {
+        std::cerr << "Only .ppm files with a maximum pixel value between 1 and 255 can be loaded." << std::endl;
         throw -1;
     }
+}
 
-    this->m_maxVal = stoi(words[0]);
+// Returns the number of bytes of pixel data the header describes
+std::size_t PPM::dataSize() const {
+    return (std::size_t) this->m_width * this->m_height * 3;
 }
 
-// Checks if the given line is a PPM comment (i.e. line starts with '#')
-bool PPM::isComment(std::string line) {
-    if (line.size() == 0) {
-        std::cerr << "PPM files should not have any empty lines." << std::endl;
+// Verifies that the pixel data the header describes can be counted, and
+// could fit in the given number of bytes left in the file
+//
+// Both dimensions have at most 9 digits, so their product is computed
+// without overflow in 64 bits. P6 needs a byte per value, and P3 at least a
+// digit and a separator for every value but the last.
+void PPM::checkDataSize(unsigned long long available, bool binary) {
+    const unsigned long long size = (unsigned long long) this->m_width * this->m_height * 3;
+
+    if (size > UINT_MAX || size > SIZE_MAX) {
+        std::cerr << "Images of " << this->m_width << "x" << this->m_height << " pixels are too large to load." << std::endl;
         throw -1;
     }
-    return line.at(0) == '#';
-}
 
-// Load the desired file into raw strings for each line
-std::vector<std::string> PPM::loadFile(std::string fileName) {
-    std::vector<std::string> fileLines;
-    std::ifstream inFile;
+    const unsigned long long needed = binary || size == 0 ? size : size * 2 - 1;
+    if (available < needed) {
+        std::cerr << "File should contain " << size << (binary ? " bytes" : " points") << " of data, but it only has "
+                  << available << " bytes left." << std::endl;
+        throw -1;
+    }
+}
 
-    inFile.open(fileName);
+// Reads the next whitespace-delimited token of the header, skipping any comments
+//
+// The whitespace character terminating the token is consumed, so after the
+// maximum pixel value has been read the stream sits at the first byte of
+// pixel data.
+std::string PPM::readHeaderToken(std::istream& in) {
+    std::string token;
+
+    int c = in.get();
+    while (c != EOF) {
+        if (c == '#') {
+            while (c != EOF && c != '\n') {
+                c = in.get();
+            }
+        }
 
-    if (inFile.is_open()) {
-        std::string line;
-        while (getline(inFile, line)) {
-            fileLines.push_back(line);
+        if (std::isspace(c)) {
+            if (!token.empty()) {
+                break;
+            }
+        } else if (c != EOF) {
+            token += (char) c;
         }
+        c = in.get();
     }
-    
-    inFile.close();
-    return fileLines;
+
+    return token;
 }
 
-// Process metadata, and then load image data into program
-void PPM::processLines(std::vector<std::string> fileContents) {
-    bool checkedVersion = false;
-    bool checkedDims = false;
-    bool checkedMax = false;
+// Reads the next whitespace-delimited token of a header held in memory, advancing
+// the cursor past the token and the whitespace character that terminates it
+std::string PPM::readHeaderToken(const char*& cursor, const char* end) {
+    while (cursor < end && (std::isspace((unsigned char) *cursor) || *cursor == '#')) {
+        if (*cursor == '#') {
+            while (cursor < end && *cursor != '\n') {
+                ++cursor;
+            }
+        } else {
+            ++cursor;
+        }
+    }
 
-    std::vector<int> numbers;
-    for (unsigned int ii = 0; ii < fileContents.size(); ++ii) {
-        std::string line = fileContents[ii];
+    const char* start = cursor;
+    while (cursor < end && !std::isspace((unsigned char) *cursor) && *cursor != '#') {
+        ++cursor;
+    }
+    std::string token(start, cursor);
 
-        if (PPM::isComment(line)) {
-            continue;
+    if (cursor < end && *cursor == '#') {
+        while (cursor < end && *cursor != '\n') {
+            ++cursor;
         }
+    }
+    if (cursor < end) {
+        ++cursor;
+    }
 
-        if (!checkedVersion) {
-            PPM::checkVersion(line);
-            checkedVersion = true;
-            continue;
-        }
+    return token;
+}
 
-        if (!checkedDims) {
-            PPM::getDims(line);
-            checkedDims = true;
-            continue;
-        }
+// Converts a header token to a non-negative integer
+int PPM::parseHeaderValue(const std::string& token, const std::string& description) {
+    if (token.empty() || token.size() > 9 || token.find_first_not_of("0123456789") != std::string::npos) {
+        std::cerr << "PPM header must specify the " << description << " as a non-negative integer." << std::endl;
+        throw -1;
+    }
 
-        if (!checkedMax) {
-            PPM::getMax(line);
-            checkedMax = true;
-            continue;
-        }
+    return std::stoi(token);
+}
 
-        std::vector<int> lineNumbers = PPM::getImageLine(line);
-        for (unsigned int jj = 0; jj < lineNumbers.size(); ++jj) {
-            numbers.push_back(lineNumbers[jj]);
+// Streams P3 ASCII pixel values straight into m_PixelData in a single pass
+//
+// The file is read through a fixed-size buffer and each value is accumulated
+// digit by digit, so a number split across two reads carries over naturally.
+void PPM::readAsciiPixels(std::istream& in) {
+    char buffer[PPM_READ_BUFFER_SIZE];
+
+    unsigned int count = 0;
+    unsigned int value = 0;
+    bool inNumber = false;
+    bool inComment = false;
+
+    while (in) {
+        in.read(buffer, sizeof(buffer));
+        std::streamsize bytesRead = in.gcount();
+
+        for (std::streamsize ii = 0; ii < bytesRead; ++ii) {
+            char c = buffer[ii];
+
+            if (inComment) {
+                inComment = c != '\n';
+                continue;
+            }
+
+            if (c >= '0' && c <= '9') {
+                // Values are capped just above the maximum so they cannot overflow
+                value = std::min(value * 10 + (c - '0'), 256u);
+                inNumber = true;
+                continue;
+            }
+
+            if (inNumber) {
+                PPM::storeAsciiValue(count, value);
+                value = 0;
+                inNumber = false;
+            }
+
+            if (c == '#') {
+                inComment = true;
+            } else if (!std::isspace((unsigned char) c)) {
+                std::cerr << "PPM pixel data may only contain integers, whitespace and comments." << std::endl;
+                throw -1;
+            }
         }
     }
 
-    PPM::setPixels(numbers);
+    if (inNumber) {
+        PPM::storeAsciiValue(count, value);
+    }
+
+    PPM::checkPixelCount(count);
 }
 
-// Separates string into a vector of words
-std::vector<std::string> PPM::separateWords(std::string line) {
-    std::vector<std::string> words;
+// Parses P3 ASCII pixel values in place from memory into m_PixelData
+void PPM::parseAsciiPixels(const char* cursor, const char* end) {
+    unsigned int count = 0;
 
-    unsigned int ii = 0;
-    while (ii < line.size()) {
-        if (line.at(ii) == ' ') {
-            ++ii;
-            continue;
-        }
-        unsigned int jj = ii;
-        for (; jj < line.size(); ++jj) {
-            if (line.at(jj) == ' ') {
-                break;
+    while (cursor < end) {
+        char c = *cursor;
+
+        if (c >= '0' && c <= '9') {
+            unsigned int value = 0;
+            std::from_chars_result result = std::from_chars(cursor, end, value);
+            if (result.ec != std::errc()) {
+                // Only out-of-range numbers can fail here, which the range check rejects
+                value = UINT_MAX;
             }
+            PPM::storeAsciiValue(count, value);
+            cursor = result.ptr;
+        } else if (c == '#') {
+            const void* newline = std::memchr(cursor, '\n', end - cursor);
+            cursor = newline ? (const char*) newline : end;
+        } else if (std::isspace((unsigned char) c)) {
+            ++cursor;
+        } else {
+            std::cerr << "PPM pixel data may only contain integers, whitespace and comments." << std::endl;
+            throw -1;
         }
-        words.push_back(line.substr(ii, jj));
-        ii = jj;
     }
 
-    return words;
+    PPM::checkPixelCount(count);
 }
 
-// With the given integer values from the file, populates the internal structure of this object to be
-// usable
-void PPM::setPixels(std::vector<int> numbers) {
-    this->m_PixelData = new unsigned char[numbers.size()];
+// Parses P3 ASCII pixel values from memory on several threads at once
+//
+// The payload is cut into one chunk per thread, with each cut moved forward
+// to the next whitespace so that no number is split. A first parallel pass
+// counts the values in every chunk; a prefix sum over those counts gives each
+// chunk its offset into m_PixelData, and a second parallel pass parses every
+// chunk straight into place.
+void PPM::parseAsciiPixelsParallel(const char* cursor, const char* end) {
+    const std::size_t length = end - cursor;
+    unsigned int numChunks = std::max(1u, std::thread::hardware_concurrency());
+    numChunks = (unsigned int) std::min<std::size_t>(numChunks, length / PPM_MIN_PARALLEL_CHUNK_SIZE);
+
+    // Comments could straddle a cut, and small payloads are not worth the threads
+    if (numChunks < 2 || std::memchr(cursor, '#', length)) {
+        PPM::parseAsciiPixels(cursor, end);
+        return;
+    }
+
+    std::vector<const char*> cuts(numChunks + 1);
+    cuts[0] = cursor;
+    cuts[numChunks] = end;
+    for (unsigned int ii = 1; ii < numChunks; ++ii) {
+        const char* cut = std::max(cursor + length * ii / numChunks, cuts[ii - 1]);
+        while (cut < end && !std::isspace((unsigned char) *cut)) {
+            ++cut;
+        }
+        cuts[ii] = cut;
+    }
+
+    std::vector<unsigned int> counts(numChunks + 1, 0);
+    std::vector<char> valid(numChunks, 1);
+    std::vector<std::thread> workers;
+
+    for (unsigned int ii = 0; ii < numChunks; ++ii) {
+        workers.emplace_back([&, ii]() {
+            valid[ii] = countAsciiValues(cuts[ii], cuts[ii + 1], counts[ii + 1]);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
 
-    int numDataPoints = this->m_width * this->m_height * 3;
-    if (numbers.size() != numDataPoints) {
-        std::cerr << "File should contain " << numDataPoints << " points of data, but it only contains " << numbers.size() << std::endl;
+    for (unsigned int ii = 0; ii < numChunks; ++ii) {
+        if (!valid[ii]) {
+            std::cerr << "PPM pixel data may only contain integers, whitespace and comments." << std::endl;
+            throw -1;
+        }
+        counts[ii + 1] += counts[ii];
     }
+    PPM::checkPixelCount(counts[numChunks]);
 
-    for (unsigned int ii = 0; ii < this->m_height; ++ii) {
-        for (unsigned int jj = 0; jj < this->m_width; ++jj) {
-            int redIndex = ii * this->m_width * 3 + jj * 3;
-            int red = numbers[redIndex];
-            int green = numbers[redIndex + 1];
-            int blue = numbers[redIndex + 2];
+    for (unsigned int ii = 0; ii < numChunks; ++ii) {
+        workers.emplace_back([&, ii]() {
+            valid[ii] = parseAsciiChunk(cuts[ii], cuts[ii + 1], this->m_PixelData + counts[ii], this->m_maxVal);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
 
-            PPM::setPixel(jj, ii, red, green, blue);
+    for (unsigned int ii = 0; ii < numChunks; ++ii) {
+        if (!valid[ii]) {
+            std::cerr << "Pixel values may not exceed the maximum value of " << this->m_maxVal << "." << std::endl;
+            throw -1;
         }
     }
 }
 
-// Converts the current state of this object to a string to be printed back out to a file
-std::string PPM::toString() {
-    std::string asString = "P3\n" +
-                           std::to_string(this->m_width) + " " + std::to_string(this->m_height) + "\n" +
-                           std::to_string(this->m_maxVal) + "\n";
+// Validates a single parsed P3 value and stores it at the next free slot of m_PixelData
+void PPM::storeAsciiValue(unsigned int& count, unsigned int value) {
+    if (count == PPM::dataSize()) {
+        std::cerr << "File contains more than " << count << " points of data." << std::endl;
+        throw -1;
+    }
+    if (value > (unsigned int) this->m_maxVal) {
+        std::cerr << "Pixel values may not exceed the maximum value of " << this->m_maxVal << "." << std::endl;
+        throw -1;
+    }
+    this->m_PixelData[count++] = (unsigned char) value;
+}
+
+// Verifies that every pixel component was present in the file
+void PPM::checkPixelCount(unsigned int count) {
+    const std::size_t size = PPM::dataSize();
+
+    if (count != size) {
+        std::cerr << "File should contain " << size << " points of data, but it only contains " << count << std::endl;
+        throw -1;
+    }
+}
 
-    for (unsigned int ii = 0; ii < this->m_height; ++ii) {
-        for (unsigned int jj = 0; jj < (this->m_width * 3); ++jj) {
-            unsigned char entry = this->m_PixelData[ii * 3 * this->m_width + jj];
-            asString += " " + std::to_string((int) entry) + " ";
+// Reads P6 binary pixel values straight into m_PixelData
+void PPM::readBinaryPixels(std::istream& in) {
+    const std::size_t size = PPM::dataSize();
 
-            if (jj % 3 == 2 && jj != this->m_width * 3) {
-                asString += "  ";
-            }
+    in.read((char*) this->m_PixelData, size);
+
+    if ((std::size_t) in.gcount() != size) {
+        std::cerr << "File should contain " << size << " bytes of data, but it only contains " << in.gcount() << std::endl;
+        throw -1;
+    }
+}
+
+// Writes the pixel data as P3 text, one "R G B" triple per line
+//
+// Text is assembled in a fixed-size buffer that is flushed whenever it fills,
+// and every component is copied from a precomputed table of the decimal
+// strings for 0-255, so memory use does not grow with the size of the image.
+void PPM::writeAsciiPixels(std::ostream& out) {
+    struct DecimalEntry {
+        char text[4];
+        unsigned char length;
+    };
+
+    static const std::vector<DecimalEntry> decimals = []() {
+        std::vector<DecimalEntry> table(256);
+        for (int ii = 0; ii < 256; ++ii) {
+            std::to_chars_result result = std::to_chars(table[ii].text, table[ii].text + 3, ii);
+            table[ii].length = (unsigned char) (result.ptr - table[ii].text);
+        }
+        return table;
+    }();
+
+    char buffer[PPM_WRITE_BUFFER_SIZE];
+    char* cursor = buffer;
+    // Room for the longest possible line, "255 255 255\n"
+    char* const flushPoint = buffer + sizeof(buffer) - 12;
+
+    const unsigned char* pixel = this->m_PixelData;
+    const unsigned char* const end = pixel + PPM::dataSize();
+
+    for (; pixel < end; pixel += 3) {
+        for (int channel = 0; channel < 3; ++channel) {
+            const DecimalEntry& entry = decimals[pixel[channel]];
+            std::memcpy(cursor, entry.text, 4);
+            cursor += entry.length;
+            *cursor++ = channel == 2 ? '\n' : ' ';
+        }
+
+        if (cursor >= flushPoint) {
+            out.write(buffer, cursor - buffer);
+            cursor = buffer;
         }
-        asString += "\n";
     }
 
-    return asString;
+    out.write(buffer, cursor - buffer);
 }
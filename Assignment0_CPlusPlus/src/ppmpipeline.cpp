@@ -0,0 +1,159 @@
+#include <algorithm>
+
+#include "PPM.h"
+#include "PPMPipeline.h"
+#include "PixelOps.h"
+
+// Bytes of pixel data every stage is run over before moving on to the next
+// tile. A whole number of pixels, and small enough to stay in the L1 cache.
+#define PPM_PIPELINE_TILE_SIZE (3 * 8 * 1024)
+
+//// PUBLIC:
+
+// Constructor records operations to be applied to the given image
+PPMPipeline::PPMPipeline(PPM& image) : m_image(image) {
+}
+
+// Subtracts amount from every component, saturating at 0
+PPMPipeline& PPMPipeline::darken(int amount) {
+    return PPMPipeline::record(OpType::Brightness, -amount, 0.0f);
+}
+
+// Adds delta to every component, saturating at 0 and 255
+PPMPipeline& PPMPipeline::brightness(int delta) {
+    return PPMPipeline::record(OpType::Brightness, delta, 0.0f);
+}
+
+// Scales every component's distance from mid-gray by factor
+PPMPipeline& PPMPipeline::contrast(float factor) {
+    return PPMPipeline::record(OpType::Contrast, 0, factor);
+}
+
+// Applies gamma correction
+PPMPipeline& PPMPipeline::gamma(float gamma) {
+    return PPMPipeline::record(OpType::Gamma, 0, gamma);
+}
+
+// Replaces every component with 255 minus itself
+PPMPipeline& PPMPipeline::invert() {
+    return PPMPipeline::record(OpType::Invert, 0, 0.0f);
+}
+
+// Reorders the channels of every pixel so that output channel c takes input channel order c
+PPMPipeline& PPMPipeline::swizzle(int red, int green, int blue) {
+    PPMPipeline::record(OpType::Swizzle, 0, 0.0f);
+    this->m_ops.back().order[0] = red;
+    this->m_ops.back().order[1] = green;
+    this->m_ops.back().order[2] = blue;
+    return *this;
+}
+
+// Replaces every pixel with its luma
+PPMPipeline& PPMPipeline::grayscale() {
+    return PPMPipeline::record(OpType::Grayscale, 0, 0.0f);
+}
+
+// Runs every recorded operation over the image in one pass, then clears the recording
+void PPMPipeline::apply() {
+    unsigned char* data = this->m_image.pixelData();
+    if (!data || this->m_ops.empty()) {
+        this->m_ops.clear();
+        return;
+    }
+
+    const std::size_t size = (std::size_t) this->m_image.getWidth() * this->m_image.getHeight() * 3;
+    std::vector<Stage> stages = PPMPipeline::buildStages();
+
+    for (std::size_t offset = 0; offset < size; offset += PPM_PIPELINE_TILE_SIZE) {
+        std::size_t tileSize = std::min((std::size_t) PPM_PIPELINE_TILE_SIZE, size - offset);
+
+        for (const Stage& stage : stages) {
+            if (stage.usesLut) {
+                PixelOps::applyLut(data + offset, tileSize, stage.lut);
+            } else {
+                PPMPipeline::runOp(stage.op, data + offset, tileSize);
+            }
+        }
+    }
+
+    this->m_ops.clear();
+}
+
+//// PRIVATE:
+
+// Adds an operation to the recording
+PPMPipeline& PPMPipeline::record(OpType type, int amount, float factor) {
+    Op op = {type, amount, factor, {0, 1, 2}};
+    this->m_ops.push_back(op);
+    return *this;
+}
+
+// Returns whether an operation transforms each component independently of the others
+bool PPMPipeline::isPerComponent(OpType type) {
+    return type == OpType::Brightness || type == OpType::Contrast ||
+           type == OpType::Gamma || type == OpType::Invert;
+}
+
+// Runs a single operation over a range of pixel data
+void PPMPipeline::runOp(const Op& op, unsigned char* data, std::size_t size) {
+    switch (op.type) {
+    case OpType::Brightness:
+        PixelOps::brightness(data, size, op.amount);
+        break;
+    case OpType::Contrast:
+        PixelOps::contrast(data, size, op.factor);
+        break;
+    case OpType::Gamma:
+        PixelOps::gamma(data, size, op.factor);
+        break;
+    case OpType::Invert:
+        PixelOps::invert(data, size);
+        break;
+    case OpType::Swizzle:
+        PixelOps::swizzle(data, size, op.order);
+        break;
+    case OpType::Grayscale:
+        PixelOps::grayscale(data, size);
+        break;
+    }
+}
+
+// Groups the recording into stages, folding per-component chains into lookup tables
+//
+// A chain is folded by running its operations, in order, over a table holding
+// every value from 0 to 255, so the table gives exactly the result the
+// operations would have produced one after the other.
+std::vector<PPMPipeline::Stage> PPMPipeline::buildStages() const {
+    std::vector<Stage> stages;
+
+    std::size_t ii = 0;
+    while (ii < this->m_ops.size()) {
+        Stage stage;
+        stage.op = this->m_ops[ii];
+
+        std::size_t chainEnd = ii;
+        while (chainEnd < this->m_ops.size() && PPMPipeline::isPerComponent(this->m_ops[chainEnd].type)) {
+            ++chainEnd;
+        }
+
+        // A lone operation is cheaper to run with its own kernel than through a
+        // table, except gamma, whose kernel builds a table of its own on every call
+        stage.usesLut = chainEnd - ii > 1 || stage.op.type == OpType::Gamma;
+        if (!stage.usesLut) {
+            stages.push_back(stage);
+            ++ii;
+            continue;
+        }
+
+        for (int value = 0; value < 256; ++value) {
+            stage.lut.bytes[value] = (unsigned char) value;
+        }
+        for (; ii < chainEnd; ++ii) {
+            PPMPipeline::runOp(this->m_ops[ii], stage.lut.bytes, 256);
+        }
+        PixelOps::prepareLut(stage.lut);
+        stages.push_back(stage);
+    }
+
+    return stages;
+}
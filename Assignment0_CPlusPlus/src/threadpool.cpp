@@ -0,0 +1,73 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+//// PUBLIC:
+
+// Constructor starts the given number of workers, or one per hardware thread if zero
+ThreadPool::ThreadPool(unsigned int numThreads) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int ii = 0; ii < numThreads; ++ii) {
+        this->m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// Destructor waits for every queued task to finish, then stops the workers
+ThreadPool::~ThreadPool() {
+    ThreadPool::wait();
+
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_stopping = true;
+    }
+    this->m_taskAvailable.notify_all();
+
+    for (std::thread& worker : this->m_workers) {
+        worker.join();
+    }
+}
+
+// Queues a task to be run on one of the workers. Tasks may submit further tasks.
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(this->m_mutex);
+        this->m_tasks.push_back(std::move(task));
+    }
+    this->m_taskAvailable.notify_one();
+}
+
+// Blocks until the queue is empty and no task is running
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+    this->m_idle.wait(lock, [this]() { return this->m_tasks.empty() && this->m_busy == 0; });
+}
+
+//// PRIVATE:
+
+// Runs queued tasks until the pool is stopped
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(this->m_mutex);
+
+    while (true) {
+        this->m_taskAvailable.wait(lock, [this]() { return this->m_stopping || !this->m_tasks.empty(); });
+        if (this->m_tasks.empty()) {
+            return;
+        }
+
+        std::function<void()> task = std::move(this->m_tasks.front());
+        this->m_tasks.pop_front();
+        ++this->m_busy;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        --this->m_busy;
+        if (this->m_tasks.empty() && this->m_busy == 0) {
+            this->m_idle.notify_all();
+        }
+    }
+}
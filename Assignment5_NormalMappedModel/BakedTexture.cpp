@@ -0,0 +1,258 @@
+#include <QDataStream>
+#include <QFileInfo>
+#include <QOpenGLPixelTransferOptions>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "BakedTexture.h"
+
+// Identifies baked textures, and the version of the format this code reads and writes
+static const char BAKED_MAGIC[4] = {'B', 'T', 'E', 'X'};
+static const quint32 BAKED_VERSION = 1;
+
+// Sizes of the fixed header and of each level's entry in the table after it
+static const qint64 BAKED_HEADER_SIZE = 24;
+static const qint64 BAKED_LEVEL_ENTRY_SIZE = 24;
+
+// Every level's pixel data starts on a multiple of this
+static const qint64 BAKED_LEVEL_ALIGNMENT = 16;
+
+// Smallest page size of the platforms we run on
+static const qint64 BAKED_PAGE_SIZE = 4096;
+
+// More levels than this would describe a texture wider than 2^31 texels
+static const quint32 BAKED_MAX_LEVELS = 32;
+
+/**
+ * Maps the baked texture at the given path into memory.
+ *
+ * @param filePath The path of the baked texture.
+ * @throws invalid_argument if the file cannot be opened or mapped, or is not
+ *                          a baked texture of a version this code reads.
+ */
+BakedTexture::BakedTexture(const QString& filePath) : file_(filePath) {
+    std::string path = filePath.toStdString();
+    if (!file_.open(QIODevice::ReadOnly)) {
+        throw std::invalid_argument("Unable to open file at: " + path);
+    }
+
+    qint64 size = file_.size();
+    if (size < BAKED_HEADER_SIZE || !(mapping_ = file_.map(0, size))) {
+        throw std::invalid_argument("Unable to map baked texture at: " + path);
+    }
+    if (!std::equal(BAKED_MAGIC, BAKED_MAGIC + 4, (const char*) mapping_)) {
+        throw std::invalid_argument("Not a baked texture: " + path);
+    }
+
+    quint32 version = qFromLittleEndian<quint32>(mapping_ + 4);
+    if (version != BAKED_VERSION) {
+        throw std::invalid_argument("Baked texture " + path + " has version " +
+                                    std::to_string(version) + ", expected " +
+                                    std::to_string(BAKED_VERSION));
+    }
+
+    channels_ = (int) qFromLittleEndian<quint32>(mapping_ + 16);
+    quint32 numLevels = qFromLittleEndian<quint32>(mapping_ + 20);
+    if ((channels_ != 3 && channels_ != 4) || numLevels == 0 || numLevels > BAKED_MAX_LEVELS ||
+        size < BAKED_HEADER_SIZE + numLevels * BAKED_LEVEL_ENTRY_SIZE) {
+        throw std::invalid_argument("Baked texture has a malformed header: " + path);
+    }
+
+    for (quint32 ii = 0; ii < numLevels; ++ii) {
+        const uchar* entry = mapping_ + BAKED_HEADER_SIZE + ii * BAKED_LEVEL_ENTRY_SIZE;
+        quint32 width = qFromLittleEndian<quint32>(entry);
+        quint32 height = qFromLittleEndian<quint32>(entry + 4);
+        quint64 offset = qFromLittleEndian<quint64>(entry + 8);
+        quint64 levelSize = qFromLittleEndian<quint64>(entry + 16);
+
+        if (width == 0 || height == 0 || levelSize != (quint64) width * height * channels_ ||
+            offset > (quint64) size || levelSize > (quint64) size - offset) {
+            throw std::invalid_argument("Baked texture has a malformed level " +
+                                        std::to_string(ii) + ": " + path);
+        }
+        levels_.push_back({(int) width, (int) height, mapping_ + offset});
+    }
+}
+
+/**
+ * Standard destructor, which unmaps the file.
+ */
+BakedTexture::~BakedTexture() {
+    if (mapping_) {
+        file_.unmap(mapping_);
+    }
+}
+
+/**
+ * Gets the number of mip levels in the file.
+ */
+int BakedTexture::getNumLevels() const {
+    return levels_.size();
+}
+
+/**
+ * Reads every page of the mapped file, so that uploading does not stall
+ * on the disk. Worth calling off the GL thread.
+ */
+void BakedTexture::prefetch() const {
+    // Touching one byte in every page is enough to fault the whole page in
+    volatile uchar sink = 0;
+    qint64 size = file_.size();
+    for (qint64 offset = 0; offset < size; offset += BAKED_PAGE_SIZE) {
+        sink = sink + mapping_[offset];
+    }
+}
+
+/**
+ * Uploads every mip level to the given texture, allocating its storage.
+ * The pixel data is read straight out of the mapped file.
+ *
+ * @param texture The texture to upload to, which must not yet have storage.
+ */
+void BakedTexture::upload(QOpenGLTexture& texture) const {
+    QOpenGLTexture::PixelFormat pixelFormat = channels_ == 4 ? QOpenGLTexture::RGBA : QOpenGLTexture::RGB;
+
+    texture.setFormat(channels_ == 4 ? QOpenGLTexture::RGBA8_UNorm : QOpenGLTexture::RGB8_UNorm);
+    texture.setSize(levels_.at(0).width, levels_.at(0).height);
+    texture.setMipLevels(levels_.size());
+    texture.allocateStorage(pixelFormat, QOpenGLTexture::UInt8);
+
+    // Rows are tightly packed, which RGB rows of odd widths would not be under the default of 4
+    QOpenGLPixelTransferOptions options;
+    options.setAlignment(1);
+    for (int ii = 0; ii < levels_.size(); ++ii) {
+        texture.setData(ii, pixelFormat, QOpenGLTexture::UInt8, levels_.at(ii).data, &options);
+    }
+}
+
+/**
+ * Gets the path of the baked texture that belongs to the given source image.
+ *
+ * @param imagePath The path of the source image.
+ * @return The same path with its extension replaced by ".btex".
+ */
+QString BakedTexture::bakedPathFor(const QString& imagePath) {
+    QFileInfo info(imagePath);
+    return info.path() + "/" + info.completeBaseName() + ".btex";
+}
+
+/**
+ * Checks whether the given source image has an up-to-date baked texture,
+ * i.e. one that exists and is no older than the image itself.
+ *
+ * @param imagePath The path of the source image.
+ * @return Whether the baked texture can be used instead of the image.
+ */
+bool BakedTexture::isBaked(const QString& imagePath) {
+    QFileInfo baked(bakedPathFor(imagePath));
+    QFileInfo image(imagePath);
+    return baked.exists() && (!image.exists() || baked.lastModified() >= image.lastModified());
+}
+
+/**
+ * Halves an image in each dimension (stopping at 1), averaging each 2x2 block
+ * of texels into one.
+ *
+ * @param source   The tightly packed texels of the larger level.
+ * @param width    The width of the larger level.
+ * @param height   The height of the larger level.
+ * @param channels The number of channels per texel.
+ * @return The tightly packed texels of the smaller level.
+ */
+static QByteArray downsample(const QByteArray& source, int width, int height, int channels) {
+    int nextWidth = std::max(1, width / 2);
+    int nextHeight = std::max(1, height / 2);
+    QByteArray result(nextWidth * nextHeight * channels, 0);
+
+    const uchar* in = (const uchar*) source.constData();
+    uchar* out = (uchar*) result.data();
+    for (int y = 0; y < nextHeight; ++y) {
+        // Levels that are one texel across average just the pair along the other axis
+        int y0 = std::min(height - 1, 2 * y);
+        int y1 = std::min(height - 1, 2 * y + 1);
+        for (int x = 0; x < nextWidth; ++x) {
+            int x0 = std::min(width - 1, 2 * x);
+            int x1 = std::min(width - 1, 2 * x + 1);
+            for (int c = 0; c < channels; ++c) {
+                int sum = in[(y0 * width + x0) * channels + c] + in[(y0 * width + x1) * channels + c] +
+                          in[(y1 * width + x0) * channels + c] + in[(y1 * width + x1) * channels + c];
+                out[(y * nextWidth + x) * channels + c] = (uchar) ((sum + 2) / 4);
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Mirrors an image the way Renderable expects, builds its mip chain, and
+ * writes the result as a baked texture.
+ *
+ * @param image      The image to be baked.
+ * @param outputPath The path of the baked texture to write.
+ * @throws invalid_argument if the image is empty or the output file cannot
+ *                          be written.
+ */
+void BakedTexture::bake(const QImage& image, const QString& outputPath) {
+    if (image.isNull()) {
+        throw std::invalid_argument("Cannot bake an empty image to: " + outputPath.toStdString());
+    }
+
+    int channels = image.hasAlphaChannel() ? 4 : 3;
+    QImage mirrored = image.mirrored(true, true)
+                          .convertToFormat(channels == 4 ? QImage::Format_RGBA8888 : QImage::Format_RGB888);
+
+    // QImage pads its scanlines to four bytes, so copy the rows out tightly packed
+    int width = mirrored.width();
+    int height = mirrored.height();
+    QByteArray level(width * height * channels, 0);
+    for (int y = 0; y < height; ++y) {
+        std::copy(mirrored.constScanLine(y), mirrored.constScanLine(y) + width * channels,
+                  level.data() + y * width * channels);
+    }
+
+    QVector<QByteArray> levels;
+    QVector<QSize> sizes;
+    levels.push_back(level);
+    sizes.push_back(QSize(width, height));
+    while (width > 1 || height > 1) {
+        levels.push_back(downsample(levels.back(), width, height, channels));
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        sizes.push_back(QSize(width, height));
+    }
+
+    QSaveFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        throw std::invalid_argument("Unable to write file at: " + outputPath.toStdString());
+    }
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.writeRawData(BAKED_MAGIC, 4);
+    stream << BAKED_VERSION << (quint32) sizes.at(0).width() << (quint32) sizes.at(0).height()
+           << (quint32) channels << (quint32) levels.size();
+
+    qint64 offset = BAKED_HEADER_SIZE + levels.size() * BAKED_LEVEL_ENTRY_SIZE;
+    QVector<qint64> offsets;
+    for (int ii = 0; ii < levels.size(); ++ii) {
+        offset = (offset + BAKED_LEVEL_ALIGNMENT - 1) / BAKED_LEVEL_ALIGNMENT * BAKED_LEVEL_ALIGNMENT;
+        offsets.push_back(offset);
+        stream << (quint32) sizes.at(ii).width() << (quint32) sizes.at(ii).height()
+               << (quint64) offset << (quint64) levels.at(ii).size();
+        offset += levels.at(ii).size();
+    }
+
+    for (int ii = 0; ii < levels.size(); ++ii) {
+        QByteArray padding(offsets.at(ii) - file.pos(), 0);
+        stream.writeRawData(padding.constData(), padding.size());
+        stream.writeRawData(levels.at(ii).constData(), levels.at(ii).size());
+    }
+
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        throw std::invalid_argument("Unable to write file at: " + outputPath.toStdString());
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QFile>
+#include <QImage>
+#include <QOpenGLTexture>
+#include <QString>
+#include <QVector>
+
+/**
+ * A texture baked ahead of time into a file that can be handed to OpenGL
+ * without decoding it.
+ *
+ * A baked file holds the image already mirrored the way Renderable expects,
+ * along with its whole mip chain down to 1x1, as tightly packed 8-bit RGB or
+ * RGBA rows. All values are little-endian:
+ *
+ *     char[4]  magic, "BTEX"
+ *     uint32   format version (currently 1)
+ *     uint32   width of level 0
+ *     uint32   height of level 0
+ *     uint32   channels (3 or 4)
+ *     uint32   number of mip levels
+ *     then for every level:
+ *         uint32 width, uint32 height, uint64 offset, uint64 size
+ *     then the pixel data of every level, each starting on a 16-byte boundary
+ *
+ * Baked files are made by the TextureBaker tool and sit next to their
+ * source image, e.g. house_diffuse.btex next to house_diffuse.ppm.
+ */
+class BakedTexture {
+public:
+    /**
+     * Maps the baked texture at the given path into memory.
+     *
+     * @param filePath The path of the baked texture.
+     * @throws invalid_argument if the file cannot be opened or mapped, or is not
+     *                          a baked texture of a version this code reads.
+     */
+    BakedTexture(const QString& filePath);
+
+    /**
+     * Standard destructor, which unmaps the file.
+     */
+    ~BakedTexture();
+
+    /**
+     * Gets the number of mip levels in the file.
+     */
+    int getNumLevels() const;
+
+    /**
+     * Reads every page of the mapped file, so that uploading does not stall
+     * on the disk. Worth calling off the GL thread.
+     */
+    void prefetch() const;
+
+    /**
+     * Uploads every mip level to the given texture, allocating its storage.
+     * The pixel data is read straight out of the mapped file.
+     *
+     * @param texture The texture to upload to, which must not yet have storage.
+     */
+    void upload(QOpenGLTexture& texture) const;
+
+    /**
+     * Gets the path of the baked texture that belongs to the given source image.
+     *
+     * @param imagePath The path of the source image.
+     * @return The same path with its extension replaced by ".btex".
+     */
+    static QString bakedPathFor(const QString& imagePath);
+
+    /**
+     * Checks whether the given source image has an up-to-date baked texture,
+     * i.e. one that exists and is no older than the image itself.
+     *
+     * @param imagePath The path of the source image.
+     * @return Whether the baked texture can be used instead of the image.
+     */
+    static bool isBaked(const QString& imagePath);
+
+    /**
+     * Mirrors an image the way Renderable expects, builds its mip chain, and
+     * writes the result as a baked texture.
+     *
+     * @param image      The image to be baked.
+     * @param outputPath The path of the baked texture to write.
+     * @throws invalid_argument if the image is empty or the output file cannot
+     *                          be written.
+     */
+    static void bake(const QImage& image, const QString& outputPath);
+
+private:
+    /**
+     * Private copy constructor, as a mapping has a single owner.
+     */
+    BakedTexture(const BakedTexture&);
+
+    /**
+     * Private assignment operator, as a mapping has a single owner.
+     */
+    BakedTexture& operator=(const BakedTexture&);
+
+    // One mip level, pointing into the mapped file
+    struct Level {
+        int width;
+        int height;
+        const uchar* data;
+    };
+
+    // File data:
+    QFile file_;
+    uchar* mapping_ = nullptr;
+
+    // Texture data:
+    int channels_ = 0;
+    QVector<Level> levels_;
+};
@@ -35,6 +35,11 @@ void BasicWidget::keyReleaseEvent(QKeyEvent* keyEvent)
     qDebug() << "W key pressed.";
     wireframeMode_ = !wireframeMode_;
     break;
+  case Qt::Key_C:
+    qDebug() << "C key pressed.";
+    frustumCulling_ = !frustumCulling_;
+    update();
+    break;
   case Qt::Key_1:
     qDebug() << "1 key pressed.";
     modelSelectedIndex_ = 0;
@@ -120,8 +125,20 @@ void BasicWidget::paintGL()
     glPolygonMode( GL_FRONT_AND_BACK, GL_FILL );
   }
 
-  renderables_.at(modelSelectedIndex_)->update(msSinceRestart);
-  renderables_.at(modelSelectedIndex_)->draw(view_, projection_);
+  // Textures finish decoding in the background, so upload them as they come in,
+  // whichever model they belong to
+  for (Renderable* renderable : renderables_) {
+    renderable->uploadReadyTextures();
+  }
+
+  Renderable* selected = renderables_.at(modelSelectedIndex_);
+  selected->update(msSinceRestart);
+
+  // Only the model on show is drawn, so there is nothing to hide it, but it is
+  // still skipped when it is off the screen
+  if (!frustumCulling_ || selected->isVisible(view_, projection_)) {
+    selected->draw(view_, projection_);
+  }
 
   update();
 }
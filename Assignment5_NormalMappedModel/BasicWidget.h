@@ -22,6 +22,9 @@ private:
 
   QVector<Renderable*> renderables_;
 
+  // Leaves out renderables that are off the screen before they reach OpenGL
+  bool frustumCulling_ = true;
+
   QOpenGLDebugLogger logger_;
 
   bool wireframeMode_;
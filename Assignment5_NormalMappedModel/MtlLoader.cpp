@@ -23,6 +23,7 @@ MtlLoader* MtlLoader::getInstance() {
 void MtlLoader::clear() {
     FileLoader::clear();
     diffuseMapPath_ = "";
+    normalMapPath_ = "";
 }
 
 /**
@@ -6,7 +6,7 @@
 #include <QtGui>
 #include <QtOpenGL>
 
-Renderable::Renderable() : vbo_(QOpenGLBuffer::VertexBuffer), ibo_(QOpenGLBuffer::IndexBuffer), diffuseMap_(QOpenGLTexture::Target2D), normalMap_(QOpenGLTexture::Target2D), numTris_(0), rotationAxis_(0.0, 1.0, 0.0), rotationSpeed_(0.125)
+Renderable::Renderable() : vbo_(QOpenGLBuffer::VertexBuffer), ibo_(QOpenGLBuffer::IndexBuffer), diffuseMap_(QOpenGLTexture::Target2D), normalMap_(QOpenGLTexture::Target2D), diffusePending_(false), normalPending_(false), diffusePlaceholder_(QOpenGLTexture::Target2D), normalPlaceholder_(QOpenGLTexture::Target2D), numTris_(0), rotationAxis_(0.0, 1.0, 0.0), rotationSpeed_(0.125)
 {
     rotationAngle_ = 0.0;
 }
@@ -19,6 +19,12 @@ Renderable::~Renderable()
     if (normalMap_.isCreated()) {
         normalMap_.destroy();
     }
+    if (diffusePlaceholder_.isCreated()) {
+        diffusePlaceholder_.destroy();
+    }
+    if (normalPlaceholder_.isCreated()) {
+        normalPlaceholder_.destroy();
+    }
     if (vbo_.isCreated()) {
         vbo_.destroy();
     }
@@ -48,6 +54,13 @@ void Renderable::createShaders()
     }
 }
 
+void Renderable::createPlaceholder(QOpenGLTexture& placeholder, const QColor& color)
+{
+    QImage texel(1, 1, QImage::Format_RGBA8888);
+    texel.fill(color);
+    placeholder.setData(texel, QOpenGLTexture::DontGenerateMipMaps);
+}
+
 void Renderable::init(TranslatedObj* object)
 {
     float* data = object->getData();
@@ -60,11 +73,26 @@ void Renderable::init(TranslatedObj* object)
     QString diffuseMapPath = QString::fromStdString(object->getDiffuseMapPath());
     QString normalMapPath = QString::fromStdString(object->getNormalMapPath());
 
-    diffuseMap_.setData(QImage(diffuseMapPath).mirrored(true, true));
-    normalMap_.setData(QImage(normalMapPath).mirrored(true, true));
+    // Decoding happens on worker threads, so every model's textures decode at once
+    TextureDecoder* decoder = TextureDecoder::getInstance();
+    diffuseFuture_ = decoder->decode(diffuseMapPath);
+    normalFuture_ = decoder->decode(normalMapPath);
+    diffusePending_ = true;
+    normalPending_ = true;
+
+    // Mid-gray, and a normal pointing straight out of the surface
+    createPlaceholder(diffusePlaceholder_, QColor(128, 128, 128));
+    createPlaceholder(normalPlaceholder_, QColor(128, 128, 255));
 
     // Set our model matrix to identity
     modelMatrix_.setToIdentity();
+    // Find the box around our positions, the first three floats of each
+    // vertex, to test against the view before drawing
+    boundsMin_ = boundsMax_ = numData < vertexSize ? QVector3D() : QVector3D(data[0], data[1], data[2]);
+    for (unsigned int i = 0; i + vertexSize <= numData; i += vertexSize) {
+        boundsMin_ = QVector3D(qMin(boundsMin_.x(), data[i]), qMin(boundsMin_.y(), data[i + 1]), qMin(boundsMin_.z(), data[i + 2]));
+        boundsMax_ = QVector3D(qMax(boundsMax_.x(), data[i]), qMax(boundsMax_.y(), data[i + 1]), qMax(boundsMax_.z(), data[i + 2]));
+    }
 
     // Set our number of trianges.
     numTris_ = numIndices / 3;
@@ -123,14 +151,28 @@ void Renderable::update(const qint64 msSinceLastFrame)
     }
 }
 
+void Renderable::uploadReadyTextures()
+{
+    // A texture that failed to decode keeps its placeholder
+    if (diffusePending_ && diffuseFuture_.isFinished()) {
+        TextureDecoder::upload(diffuseFuture_.result(), diffuseMap_);
+        // Let go of the decoded texels
+        diffuseFuture_ = QFuture<DecodedTexture>();
+        diffusePending_ = false;
+    }
+    if (normalPending_ && normalFuture_.isFinished()) {
+        TextureDecoder::upload(normalFuture_.result(), normalMap_);
+        normalFuture_ = QFuture<DecodedTexture>();
+        normalPending_ = false;
+    }
+}
+
 void Renderable::draw(const QMatrix4x4& view, const QMatrix4x4& projection)
 {
-    // Create our model matrix.
-    QMatrix4x4 rotMatrix;
-    rotMatrix.setToIdentity();
-    rotMatrix.rotate(rotationAngle_, rotationAxis_);
+    uploadReadyTextures();
 
-    QMatrix4x4 modelMat = modelMatrix_ * rotMatrix;
+    // Create our model matrix.
+    QMatrix4x4 modelMat = modelTransform();
     // Make sure our state is what we want
     shader_.bind();
     // Set our matrix uniforms!
@@ -146,18 +188,52 @@ void Renderable::draw(const QMatrix4x4& view, const QMatrix4x4& projection)
 
     vao_.bind();
     
-    diffuseMap_.bind(0);
-    normalMap_.bind(1);
+    QOpenGLTexture& diffuseMap = diffuseMap_.isStorageAllocated() ? diffuseMap_ : diffusePlaceholder_;
+    QOpenGLTexture& normalMap = normalMap_.isStorageAllocated() ? normalMap_ : normalPlaceholder_;
+    diffuseMap.bind(0);
+    normalMap.bind(1);
 
     glDrawElements(GL_TRIANGLES, 3 * numTris_, GL_UNSIGNED_INT, 0);
     
-    normalMap_.release(1);
-    diffuseMap_.release(0);
+    normalMap.release(1);
+    diffuseMap.release(0);
 
     vao_.release();
     shader_.release();
 }
 
+QMatrix4x4 Renderable::modelTransform() const
+{
+    QMatrix4x4 rotMatrix;
+    rotMatrix.setToIdentity();
+    rotMatrix.rotate(rotationAngle_, rotationAxis_);
+
+    return modelMatrix_ * rotMatrix;
+}
+
+bool Renderable::isVisible(const QMatrix4x4& view, const QMatrix4x4& projection) const
+{
+    QMatrix4x4 transform = projection * view * modelTransform();
+    // One bit per side of the view, -x, +x, -y, +y, -z and +z in clip space,
+    // cleared as soon as any corner lies on the inner side of it
+    int outside = 0x3F;
+    for (int corner = 0; corner < 8 && outside != 0; ++corner) {
+        QVector3D position((corner & 1) ? boundsMax_.x() : boundsMin_.x(),
+                           (corner & 2) ? boundsMax_.y() : boundsMin_.y(),
+                           (corner & 4) ? boundsMax_.z() : boundsMin_.z());
+        QVector4D clip = transform * QVector4D(position, 1.0f);
+        int sides = 0;
+        sides |= (clip.x() < -clip.w()) ? 0x01 : 0;
+        sides |= (clip.x() > clip.w()) ? 0x02 : 0;
+        sides |= (clip.y() < -clip.w()) ? 0x04 : 0;
+        sides |= (clip.y() > clip.w()) ? 0x08 : 0;
+        sides |= (clip.z() < -clip.w()) ? 0x10 : 0;
+        sides |= (clip.z() > clip.w()) ? 0x20 : 0;
+        outside &= sides;
+    }
+    return outside == 0;
+}
+
 void Renderable::setModelMatrix(const QMatrix4x4& transform)
 {
     modelMatrix_ = transform;
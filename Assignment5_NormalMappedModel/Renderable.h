@@ -4,6 +4,7 @@
 #include <QtGui>
 #include <QtOpenGL>
 
+#include "TextureDecoder.h"
 #include "TranslatedObj.h"
 
 class Renderable {
@@ -15,6 +16,14 @@ protected:
     // For now, we have only two textures per object
     QOpenGLTexture diffuseMap_;
     QOpenGLTexture normalMap_;
+    // Our textures are decoded in the background, and uploaded once they're ready
+    QFuture<DecodedTexture> diffuseFuture_;
+    QFuture<DecodedTexture> normalFuture_;
+    bool diffusePending_;
+    bool normalPending_;
+    // Until then, we draw with single texel stand-ins
+    QOpenGLTexture diffusePlaceholder_;
+    QOpenGLTexture normalPlaceholder_;
     // For now, we have a single unified buffer per object
     QOpenGLBuffer vbo_;
     // Make sure we have an index buffer.
@@ -29,8 +38,16 @@ protected:
     float rotationSpeed_;
     float rotationAngle_;
 
+    // The box around our positions, before the model matrix places it
+    QVector3D boundsMin_;
+    QVector3D boundsMax_;
+
     // Create our shader and fix it up
     void createShaders();
+    // Fill a placeholder texture with a single texel of the given color
+    void createPlaceholder(QOpenGLTexture& placeholder, const QColor& color);
+    // The model matrix we are drawn with
+    virtual QMatrix4x4 modelTransform() const;
 
 public:
     Renderable();
@@ -39,11 +56,17 @@ public:
     virtual void init(TranslatedObj* object);
     virtual void update(const qint64 msSinceLastFrame);
     virtual void draw(const QMatrix4x4& view, const QMatrix4x4& projection);
+    // Upload any textures that have finished decoding. Needs a current context.
+    void uploadReadyTextures();
 
     void setModelMatrix(const QMatrix4x4& transform);
     void setRotationAxis(const QVector3D& axis);
     void setRotationSpeed(float speed);
 
+    // Whether any of our bounding box might be on screen. The box is only
+    // rejected when all of its corners lie outside the same side of the view.
+    bool isVisible(const QMatrix4x4& view, const QMatrix4x4& projection) const;
+
     static Renderable* createFromFile(const std::string& filePath);
 
 private:
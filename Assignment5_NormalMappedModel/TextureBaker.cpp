@@ -0,0 +1,81 @@
+/**
+ * Bakes images into textures that Renderable can load without decoding them.
+ *
+ * Usage: TextureBaker <image or .mtl file> [...]
+ *
+ * Each image is written next to itself with a .btex extension. Given a .mtl
+ * file, the diffuse and normal maps it names are baked instead, so the
+ * textures for a model can be baked with e.g.
+ *
+ *     TextureBaker ../../objects/house/house_obj.mtl
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "BakedTexture.h"
+#include "MtlLoader.h"
+
+/**
+ * Bakes a single image next to itself.
+ *
+ * @param imagePath The path of the image to be baked.
+ * @throws invalid_argument if the image cannot be read or the baked texture
+ *                          cannot be written.
+ */
+static void bakeImage(const std::string& imagePath) {
+    QString path = QString::fromStdString(imagePath);
+    QImage image(path);
+    if (image.isNull()) {
+        throw std::invalid_argument("Unable to read image at: " + imagePath);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QString outputPath = BakedTexture::bakedPathFor(path);
+    BakedTexture::bake(image, outputPath);
+    std::cout << imagePath << " -> " << outputPath.toStdString() << " ("
+              << timer.elapsed() << " ms)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    // Image format plugins, such as the one for .jpg, need an application to be found
+    QCoreApplication app(argc, argv);
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <image or .mtl file> [...]" << std::endl;
+        return 1;
+    }
+
+    int failed = 0;
+    for (int ii = 1; ii < argc; ++ii) {
+        std::string path = argv[ii];
+        try {
+            if (QString::fromStdString(path).endsWith(".mtl", Qt::CaseInsensitive)) {
+                MtlLoader* loader = MtlLoader::getInstance();
+                loader->loadFile(path);
+                std::string diffuseMapPath = loader->getDiffuseMapPath();
+                std::string normalMapPath = loader->getNormalMapPath();
+                loader->clear();
+
+                if (!diffuseMapPath.empty()) {
+                    bakeImage(diffuseMapPath);
+                }
+                if (!normalMapPath.empty()) {
+                    bakeImage(normalMapPath);
+                }
+            } else {
+                bakeImage(path);
+            }
+        } catch (std::exception& ex) {
+            std::cerr << ex.what() << std::endl;
+            ++failed;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
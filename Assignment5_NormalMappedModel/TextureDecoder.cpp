@@ -0,0 +1,98 @@
+#include <QtConcurrent>
+
+#include <iostream>
+#include <stdexcept>
+
+#include "TextureDecoder.h"
+
+// Global static pointer used to ensure a single instance of the class.
+TextureDecoder* TextureDecoder::decoderInstance_ = NULL;
+
+/**
+ * Method for singleton behavior.
+ */
+TextureDecoder* TextureDecoder::getInstance() {
+    if (!decoderInstance_) {
+        decoderInstance_ = new TextureDecoder();
+    }
+    return decoderInstance_;
+}
+
+/**
+ * Starts decoding the texture for the given image on a worker thread,
+ * preferring its baked texture if it has an up-to-date one.
+ *
+ * @param imagePath The path of the source image.
+ * @return A future holding the decoded texture once it is ready. A texture
+ *         that could not be decoded at all holds a null image.
+ */
+QFuture<DecodedTexture> TextureDecoder::decode(const QString& imagePath) {
+    return QtConcurrent::run(&pool_, &TextureDecoder::decodeNow, imagePath);
+}
+
+/**
+ * Uploads a decoded texture, which must be called with a current context.
+ *
+ * @param decoded The decoded texture, as returned through decode.
+ * @param texture The texture to upload to, which must not yet have storage.
+ * @return Whether anything was uploaded.
+ */
+bool TextureDecoder::upload(const DecodedTexture& decoded, QOpenGLTexture& texture) {
+    if (decoded.baked) {
+        decoded.baked->upload(texture);
+        return true;
+    }
+    if (decoded.image.isNull()) {
+        return false;
+    }
+    texture.setData(decoded.image);
+    return true;
+}
+
+/**
+ * Standard private constructor, which sizes the pool to the number of
+ * hardware threads.
+ */
+TextureDecoder::TextureDecoder() {
+    pool_.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+/**
+ * Private copy constructor to enforce singleton behavior.
+ */
+TextureDecoder::TextureDecoder(const TextureDecoder&) { }
+
+/**
+ * Private assignment operator to enforce singleton behavior.
+ */
+TextureDecoder& TextureDecoder::operator=(const TextureDecoder&) {
+    return *this;
+}
+
+/**
+ * Decodes the texture for the given image, run on a worker thread.
+ *
+ * @param imagePath The path of the source image.
+ * @return The decoded texture.
+ */
+DecodedTexture TextureDecoder::decodeNow(const QString& imagePath) {
+    DecodedTexture decoded;
+
+    // A baked texture only needs mapping, and is already mirrored and mipmapped
+    if (BakedTexture::isBaked(imagePath)) {
+        try {
+            decoded.baked.reset(new BakedTexture(BakedTexture::bakedPathFor(imagePath)));
+            decoded.baked->prefetch();
+            return decoded;
+        } catch (std::exception& ex) {
+            std::cout << ex.what() << std::endl;
+        }
+    }
+
+    // Convert here as well, so that QOpenGLTexture has nothing left to do but upload
+    decoded.image = QImage(imagePath).mirrored(true, true).convertToFormat(QImage::Format_RGBA8888);
+    if (decoded.image.isNull()) {
+        std::cout << "Unable to decode texture at: " << imagePath.toStdString() << std::endl;
+    }
+    return decoded;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QFuture>
+#include <QImage>
+#include <QOpenGLTexture>
+#include <QSharedPointer>
+#include <QString>
+#include <QThreadPool>
+
+#include "BakedTexture.h"
+
+/**
+ * A texture decoded into CPU memory, ready to be uploaded on the GL thread.
+ * Holds either a baked texture or a decoded image.
+ */
+struct DecodedTexture {
+    QSharedPointer<BakedTexture> baked;
+    QImage image;
+};
+
+/**
+ * Class to decode textures on a pool of worker threads, so that the GL thread
+ * only has to upload them.
+ */
+class TextureDecoder {
+public:
+    /**
+     * Method for singleton behavior.
+     */
+    static TextureDecoder* getInstance();
+
+    /**
+     * Starts decoding the texture for the given image on a worker thread,
+     * preferring its baked texture if it has an up-to-date one.
+     *
+     * @param imagePath The path of the source image.
+     * @return A future holding the decoded texture once it is ready. A texture
+     *         that could not be decoded at all holds a null image.
+     */
+    QFuture<DecodedTexture> decode(const QString& imagePath);
+
+    /**
+     * Uploads a decoded texture, which must be called with a current context.
+     *
+     * @param decoded The decoded texture, as returned through decode.
+     * @param texture The texture to upload to, which must not yet have storage.
+     * @return Whether anything was uploaded.
+     */
+    static bool upload(const DecodedTexture& decoded, QOpenGLTexture& texture);
+
+private:
+    /**
+     * Standard private constructor, which sizes the pool to the number of
+     * hardware threads.
+     */
+    TextureDecoder();
+
+    /**
+     * Private copy constructor to enforce singleton behavior.
+     */
+    TextureDecoder(const TextureDecoder&);
+
+    /**
+     * Private assignment operator to enforce singleton behavior.
+     */
+    TextureDecoder& operator=(const TextureDecoder&);
+
+    /**
+     * Decodes the texture for the given image, run on a worker thread.
+     *
+     * @param imagePath The path of the source image.
+     * @return The decoded texture.
+     */
+    static DecodedTexture decodeNow(const QString& imagePath);
+
+    // Worker threads:
+    QThreadPool pool_;
+
+    // Singleton decoder instance:
+    static TextureDecoder* decoderInstance_;
+};
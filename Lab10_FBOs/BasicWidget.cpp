@@ -44,6 +44,10 @@ void BasicWidget::keyReleaseEvent(QKeyEvent* keyEvent)
     camera_.setPosition(QVector3D(0.5, 0.5, -2.0));
     camera_.setLookAt(QVector3D(0.5, 0.5, 0.0));
     update();
+  } else if (keyEvent->key() == Qt::Key_C) {
+    occlusionCulling_ = !occlusionCulling_;
+    qDebug() << "Occlusion culling" << (occlusionCulling_ ? "on" : "off");
+    update();
   } else {
     qDebug() << "You Pressed an unsupported Key!";
   }
@@ -238,6 +242,21 @@ void BasicWidget::paintGL()
   // When we draw, we are now rendering into our FBO
   for (auto renderable : renderables_) {
       renderable->update(msSinceRestart);
+  }
+
+  // Draw the occluders into the culler's depth buffer first, so whatever
+  // they hide need not be drawn at all
+  if (occlusionCulling_) {
+      culler_.beginFrame(camera_.getViewMatrix(), camera_.getProjectionMatrix());
+      for (auto renderable : renderables_) {
+          renderable->drawOccluder(culler_, world_);
+      }
+  }
+
+  for (auto renderable : renderables_) {
+      if (occlusionCulling_ && !renderable->isVisible(culler_, world_)) {
+          continue;
+      }
       // TODO:  Understand that the camera is now governing the view and projection matrices
       renderable->draw(world_, camera_.getViewMatrix(), camera_.getProjectionMatrix());
   }
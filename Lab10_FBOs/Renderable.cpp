@@ -57,6 +57,12 @@ void Renderable::init(const QVector<QVector3D>& positions, const QVector<QVector
 
 	// Set our model matrix to identity
 	modelMatrix_.setToIdentity();
+	// Find the box around our positions, for the occlusion culler to test
+	boundsMin_ = boundsMax_ = positions.isEmpty() ? QVector3D() : positions.at(0);
+	for (const QVector3D& position : positions) {
+		boundsMin_ = QVector3D(qMin(boundsMin_.x(), position.x()), qMin(boundsMin_.y(), position.y()), qMin(boundsMin_.z(), position.z()));
+		boundsMax_ = QVector3D(qMax(boundsMax_.x(), position.x()), qMax(boundsMax_.y(), position.y()), qMax(boundsMax_.z(), position.z()));
+	}
 	// Load our texture.
 	texture_.setData(QImage(textureFile));
 
@@ -143,13 +149,7 @@ void Renderable::toggleFillMode()
 void Renderable::draw(const QMatrix4x4& world, const QMatrix4x4& view, const QMatrix4x4& projection)
 {
 	// Create our model matrix.
-	QMatrix4x4 rotMatrix;
-	rotMatrix.setToIdentity();
-	rotMatrix.rotate(rotationAngle_, rotationAxis_);
-
-	// incorporate a real world transform if want it.
-	QMatrix4x4 modelMat = modelMatrix_ * rotMatrix;
-	modelMat = world * modelMat;
+	QMatrix4x4 modelMat = modelTransform(world);
 	// Make sure our state is what we want
 	shader_.bind();
 	// Set our matrix uniforms!
@@ -167,6 +167,34 @@ void Renderable::draw(const QMatrix4x4& world, const QMatrix4x4& view, const QMa
 	shader_.release();
 }
 
+QMatrix4x4 Renderable::modelTransform(const QMatrix4x4& world) const
+{
+	QMatrix4x4 rotMatrix;
+	rotMatrix.setToIdentity();
+	rotMatrix.rotate(rotationAngle_, rotationAxis_);
+
+	// incorporate a real world transform if want it.
+	return world * modelMatrix_ * rotMatrix;
+}
+
+void Renderable::setOccluder(const QVector<QVector3D>& positions, const QVector<unsigned int>& indexes)
+{
+	occluderPositions_ = positions;
+	occluderIndices_ = indexes;
+}
+
+void Renderable::drawOccluder(OcclusionCuller& culler, const QMatrix4x4& world) const
+{
+	if (!occluderIndices_.isEmpty()) {
+		culler.drawOccluder(occluderPositions_, occluderIndices_, modelTransform(world));
+	}
+}
+
+bool Renderable::isVisible(const OcclusionCuller& culler, const QMatrix4x4& world) const
+{
+	return culler.isVisible(boundsMin_, boundsMax_, modelTransform(world));
+}
+
 void Renderable::setModelMatrix(const QMatrix4x4& transform)
 {
 	modelMatrix_ = transform;
@@ -0,0 +1,108 @@
+#ifndef DEPTH_BUFFER_H
+#define DEPTH_BUFFER_H
+
+/** @file DepthBuffer.h
+ *  @brief A depth buffer to go beside a TGA image
+ *
+ *  Note this is implemented as a header only library.
+ *  This is to make this code easy to be shared.
+ *
+ *  Holds one float per pixel, from 0 at the near plane to 1 at the far
+ *  plane, so smaller values are nearer. On top of that it keeps the
+ *  largest (farthest) depth of every 8x8 tile of pixels. A triangle whose
+ *  nearest point over a tile is no nearer than that tile's farthest pixel
+ *  cannot show through anywhere in it, so the whole tile can be skipped
+ *  without testing its pixels one at a time.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <vector>
+
+// Width and height in pixels of the tiles whose farthest depth is kept
+#define DEPTH_TILE_SIZE 8
+
+class DepthBuffer {
+public:
+
+    // Constructor
+    // Every pixel starts out at the far plane.
+    DepthBuffer(unsigned int width, unsigned int height) : m_width(width), m_height(height) {
+        m_tilesX = (width + DEPTH_TILE_SIZE - 1) / DEPTH_TILE_SIZE;
+        m_tilesY = (height + DEPTH_TILE_SIZE - 1) / DEPTH_TILE_SIZE;
+        m_depth.resize(width * height);
+        m_tileMax.resize(m_tilesX * m_tilesY);
+        clear();
+    }
+
+    // Sets every pixel, and every tile, back to the given depth
+    void clear(float depth = 1.0f) {
+        std::fill(m_depth.begin(), m_depth.end(), depth);
+        std::fill(m_tileMax.begin(), m_tileMax.end(), depth);
+    }
+
+    // Width of the buffer in pixels
+    unsigned int getWidth() const {
+        return m_width;
+    }
+
+    // Height of the buffer in pixels
+    unsigned int getHeight() const {
+        return m_height;
+    }
+
+    // Depth of a single pixel
+    float getDepth(int x, int y) const {
+        return m_depth[y * m_width + x];
+    }
+
+    // Returns the depth of every pixel, a row at a time
+    float* getDepthData() {
+        return m_depth.data();
+    }
+
+    // Farthest depth of any pixel of the tile containing the given pixel
+    float getTileMax(int x, int y) const {
+        return m_tileMax[(y / DEPTH_TILE_SIZE) * m_tilesX + x / DEPTH_TILE_SIZE];
+    }
+
+    // Finds the farthest depth of the tile containing the given pixel again,
+    // after some of its pixels have been drawn nearer
+    void updateTileMax(int x, int y) {
+        const int tileX = x / DEPTH_TILE_SIZE * DEPTH_TILE_SIZE;
+        const int tileY = y / DEPTH_TILE_SIZE * DEPTH_TILE_SIZE;
+        const int endX = std::min<int>(tileX + DEPTH_TILE_SIZE, m_width);
+        const int endY = std::min<int>(tileY + DEPTH_TILE_SIZE, m_height);
+
+        float farthest = 0.0f;
+        for (int yy = tileY; yy < endY; ++yy) {
+            const float* row = &m_depth[yy * m_width];
+            for (int xx = tileX; xx < endX; ++xx) {
+                farthest = std::max(farthest, row[xx]);
+            }
+        }
+        m_tileMax[(y / DEPTH_TILE_SIZE) * m_tilesX + x / DEPTH_TILE_SIZE] = farthest;
+    }
+
+private:
+    unsigned int m_width;
+    unsigned int m_height;
+    unsigned int m_tilesX;
+    unsigned int m_tilesY;
+    std::vector<float> m_depth;
+    std::vector<float> m_tileMax;
+};
+
+// Turns a distance in front of the camera into a depth for the buffer,
+// the way a perspective projection does: 0 at the near plane and 1 at the
+// far plane. The result is a linear function of 1 / distance, and so,
+// unlike the distance itself, changes linearly across the screen; it can
+// be interpolated between a triangle's vertices without any correction.
+float depthFromDistance(float distance, float nearPlane, float farPlane) {
+    return farPlane * (distance - nearPlane) / (distance * (farPlane - nearPlane));
+}
+
+#endif
@@ -1,3 +1,6 @@
+#ifndef GL_H
+#define GL_H
+
 /** @file GL.h
  *  @brief Our Great Looking Software Render functions
  *  
@@ -9,12 +12,22 @@
  */
 
 // Graphic Pipeline States
-// Globals that define how to draw our shapes.
+// Values that define how to draw our shapes.
 const int LINE = 0;
 const int FILL = 1;
-int glFillMode = LINE;
+const int FILL_EDGE = 2;
+const int FILL_BLOCK = 3;
+
+// The fill mode triangle() draws with. Each thread has its own, the way
+// each thread has its own current context in OpenGL, so threads drawing
+// at the same time never change each other's. To keep a fill mode, and
+// the rest of the pipeline's state, with the image being drawn on rather
+// than with the thread, use a RenderContext (see RenderContext.h).
+thread_local int glFillMode = LINE;
 
 // By default the Fill mode is LINE
 void glPolygonMode(const int mode) {
     glFillMode = mode;
 }
+
+#endif
@@ -13,6 +13,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 
 // Structure for plotting integer points.
 struct Vec2{
@@ -71,4 +72,170 @@ struct Vec2{
     }
 };
 
+// Structure for points and directions in 3D space.
+struct Vec3{
+    float x, y, z;
+
+    // Default Constructor
+    Vec3() {
+        x = y = z = 0.0f;
+    }
+
+    // Constructor with three arguments.
+    Vec3(float _x, float _y, float _z): x{_x}, y{_y}, z{_z} { }
+
+    // Add operator
+    Vec3 operator+(const Vec3& a) const {
+        return Vec3(this->x + a.x, this->y + a.y, this->z + a.z);
+    }
+
+    // Subtract operator
+    Vec3 operator-(const Vec3& a) const {
+        return Vec3(this->x - a.x, this->y - a.y, this->z - a.z);
+    }
+
+    // Scalar Multiplication
+    Vec3 operator*(const float& a) const {
+        return Vec3(this->x * a, this->y * a, this->z * a);
+    }
+
+    // Dot product
+    float dot(const Vec3& a) const {
+        return this->x * a.x + this->y * a.y + this->z * a.z;
+    }
+
+    // Cross product
+    Vec3 cross(const Vec3& a) const {
+        return Vec3(this->y * a.z - this->z * a.y,
+                    this->z * a.x - this->x * a.z,
+                    this->x * a.y - this->y * a.x);
+    }
+
+    // Gives a vector in the same direction with a length of one
+    Vec3 normalized() const {
+        float length = std::sqrt(this->dot(*this));
+        return length > 0.0f ? *this * (1.0f / length) : *this;
+    }
+
+    // Gives a vector that consists of the minimum component of each vector
+    Vec3 min(const Vec3& that) const {
+        return Vec3(std::min(this->x, that.x), std::min(this->y, that.y), std::min(this->z, that.z));
+    }
+
+    // Gives a vector that consists of the maximum component of each vector
+    Vec3 max(const Vec3& that) const {
+        return Vec3(std::max(this->x, that.x), std::max(this->y, that.y), std::max(this->z, that.z));
+    }
+};
+
+// Structure for points in homogeneous coordinates, as they come out of a
+// projection.
+struct Vec4{
+    float x, y, z, w;
+
+    // Default Constructor
+    Vec4() {
+        x = y = z = w = 0.0f;
+    }
+
+    // Constructor with four arguments.
+    Vec4(float _x, float _y, float _z, float _w): x{_x}, y{_y}, z{_z}, w{_w} { }
+};
+
+// Structure for 4x4 transformation matrices, stored a row at a time and
+// applied to column vectors, as in OpenGL.
+struct Mat4{
+    float m[4][4];
+
+    // Default Constructor
+    // Gives the identity matrix.
+    Mat4() {
+        for (int row = 0; row < 4; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                m[row][col] = row == col ? 1.0f : 0.0f;
+            }
+        }
+    }
+
+    // Matrix multiplication: the result applies that, then this
+    Mat4 operator*(const Mat4& that) const {
+        Mat4 result;
+        for (int row = 0; row < 4; ++row) {
+            for (int col = 0; col < 4; ++col) {
+                result.m[row][col] = this->m[row][0] * that.m[0][col] + this->m[row][1] * that.m[1][col] +
+                                     this->m[row][2] * that.m[2][col] + this->m[row][3] * that.m[3][col];
+            }
+        }
+        return result;
+    }
+
+    // Transforms a point (with a w of one)
+    Vec4 transform(const Vec3& p) const {
+        return Vec4(m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3],
+                    m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3],
+                    m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3],
+                    m[3][0] * p.x + m[3][1] * p.y + m[3][2] * p.z + m[3][3]);
+    }
+
+    // Gives a matrix that moves points by the given offset
+    static Mat4 translation(const Vec3& offset) {
+        Mat4 result;
+        result.m[0][3] = offset.x;
+        result.m[1][3] = offset.y;
+        result.m[2][3] = offset.z;
+        return result;
+    }
+
+    // Gives a matrix that scales points by the given factor about the origin
+    static Mat4 scale(float factor) {
+        Mat4 result;
+        result.m[0][0] = result.m[1][1] = result.m[2][2] = factor;
+        return result;
+    }
+
+    // Gives a matrix that rotates points about the y axis by the given angle
+    // in radians
+    static Mat4 rotationY(float angle) {
+        Mat4 result;
+        result.m[0][0] = std::cos(angle);
+        result.m[0][2] = std::sin(angle);
+        result.m[2][0] = -std::sin(angle);
+        result.m[2][2] = std::cos(angle);
+        return result;
+    }
+
+    // Gives a view matrix for a camera at eye looking towards target, with
+    // the camera looking down its -z axis as in OpenGL
+    static Mat4 lookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+        Vec3 forward = (target - eye).normalized();
+        Vec3 right = forward.cross(up).normalized();
+        Vec3 trueUp = right.cross(forward);
+
+        Mat4 result;
+        result.m[0][0] = right.x;    result.m[0][1] = right.y;    result.m[0][2] = right.z;
+        result.m[1][0] = trueUp.x;   result.m[1][1] = trueUp.y;   result.m[1][2] = trueUp.z;
+        result.m[2][0] = -forward.x; result.m[2][1] = -forward.y; result.m[2][2] = -forward.z;
+        result.m[0][3] = -right.dot(eye);
+        result.m[1][3] = -trueUp.dot(eye);
+        result.m[2][3] = forward.dot(eye);
+        return result;
+    }
+
+    // Gives a perspective projection with the given vertical field of view in
+    // radians. After dividing by w, x and y run from -1 to 1 across the view,
+    // and z from 0 at the near plane to 1 at the far plane, the range of a
+    // DepthBuffer.
+    static Mat4 perspective(float fieldOfView, float aspect, float nearPlane, float farPlane) {
+        float focal = 1.0f / std::tan(fieldOfView / 2.0f);
+        Mat4 result;
+        result.m[0][0] = focal / aspect;
+        result.m[1][1] = focal;
+        result.m[2][2] = -farPlane / (farPlane - nearPlane);
+        result.m[2][3] = -farPlane * nearPlane / (farPlane - nearPlane);
+        result.m[3][2] = -1.0f;
+        result.m[3][3] = 0.0f;
+        return result;
+    }
+};
+
 #endif
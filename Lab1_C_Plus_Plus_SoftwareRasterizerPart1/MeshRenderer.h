@@ -0,0 +1,196 @@
+#ifndef MESH_RENDERER_H
+#define MESH_RENDERER_H
+
+/** @file MeshRenderer.h
+ *  @brief Draws indexed triangle meshes onto a TGA image
+ *
+ *  Note this is implemented as a header only library.
+ *  This is to make this code easy to be shared.
+ *
+ *  Meshes come in the layout OpenGL takes them in, and that TranslatedObj
+ *  produces in the Assignment5 project: an array of floats holding a fixed
+ *  number of floats per vertex, starting with its x, y and z, and an array
+ *  of unsigned ints, three per triangle, indexing into it.
+ *
+ *  Drawing is split in two stages like a GPU's. The vertex stage
+ *  transforms a vertex to the screen, and the triangle stage fills each
+ *  triangle with a depth test. Most vertices of a mesh are shared by
+ *  several triangles, so the transformed vertices are kept in a
+ *  post-transform cache indexed like the vertex array, and each vertex is
+ *  transformed only once per draw, however many triangles use it.
+ *
+ *  drawIndexed fills each triangle in a single flat shade. drawIndexedTextured
+ *  takes texture coordinates and normals as well, and fills each triangle
+ *  with a texture lit by its interpolated normals.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// User libraries
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "DepthBuffer.h"
+#include "Rasterizer.h"
+#include "Texture.h"
+
+class MeshRenderer {
+public:
+
+    // Constructor
+    // Draws onto the given image, testing against the given depth buffer,
+    // which must be the same size.
+    MeshRenderer(TGA& image, DepthBuffer& depth) : m_image(image), m_depth(depth) { }
+
+    // Sets the direction, in the same space as the vertices, that light
+    // comes from. Each triangle is shaded by how directly it faces it.
+    void setLightDirection(const Vec3& direction) {
+        m_lightDirection = direction.normalized();
+    }
+
+    // Draws the triangles of a mesh, transforming every vertex by transform
+    // (typically projection * view * model). vertexSize is the number of
+    // floats per vertex, of which the first three are its position, and
+    // numIndices the number of entries in indices. Triangles reaching in
+    // front of the near plane or behind the far plane are skipped.
+    void drawIndexed(const float* vertices, unsigned int vertexSize, const unsigned int* indices,
+                     unsigned int numIndices, const Mat4& transform, ColorRGB color) {
+        newGeneration();
+
+        for (unsigned int ii = 0; ii + 2 < numIndices; ii += 3) {
+            ScreenVertex s0 = transformVertex(vertices, vertexSize, indices[ii], transform);
+            ScreenVertex s1 = transformVertex(vertices, vertexSize, indices[ii + 1], transform);
+            ScreenVertex s2 = transformVertex(vertices, vertexSize, indices[ii + 2], transform);
+            if (!s0.visible || !s1.visible || !s2.visible) {
+                continue;
+            }
+
+            // Flat shading from the triangle's untransformed positions
+            Vec3 p0 = position(vertices, vertexSize, indices[ii]);
+            Vec3 p1 = position(vertices, vertexSize, indices[ii + 1]);
+            Vec3 p2 = position(vertices, vertexSize, indices[ii + 2]);
+            float facing = std::abs((p1 - p0).cross(p2 - p0).normalized().dot(m_lightDirection));
+            float intensity = 0.15f + 0.85f * facing;
+
+            ColorRGB shaded;
+            shaded.r = (unsigned char)(color.r * intensity);
+            shaded.g = (unsigned char)(color.g * intensity);
+            shaded.b = (unsigned char)(color.b * intensity);
+
+            fillTriangleDepth(s0.position, s1.position, s2.position, s0.depth, s1.depth, s2.depth,
+                              m_image, m_depth, shaded);
+        }
+    }
+
+    // Draws the triangles of a mesh with a texture, as drawIndexed does.
+    // Every vertex is eight floats, as readTexturedObj (see ObjReader.h)
+    // gives them: its position, its texture coordinates, and its normal.
+    // Each pixel takes the texture's color, lit by the normal at that pixel.
+    void drawIndexedTextured(const float* vertices, const unsigned int* indices, unsigned int numIndices,
+                             const Mat4& transform, const Texture& texture) {
+        const unsigned int vertexSize = 8;
+        newGeneration();
+
+        for (unsigned int ii = 0; ii + 2 < numIndices; ii += 3) {
+            TexturedVertex corners[3];
+            bool visible = true;
+            for (int vv = 0; vv < 3 && visible; ++vv) {
+                ScreenVertex screen = transformVertex(vertices, vertexSize, indices[ii + vv], transform);
+                visible = screen.visible;
+
+                const float* vertex = vertices + (size_t)indices[ii + vv] * vertexSize;
+                corners[vv].position = screen.position;
+                corners[vv].depth = screen.depth;
+                corners[vv].inverseW = screen.inverseW;
+                corners[vv].u = vertex[3];
+                corners[vv].v = vertex[4];
+                corners[vv].normal = Vec3(vertex[5], vertex[6], vertex[7]);
+            }
+            if (visible) {
+                fillTriangleTextured(corners[0], corners[1], corners[2], m_image, m_depth, texture, m_lightDirection);
+            }
+        }
+    }
+
+    // Number of vertices the vertex stage has transformed, over every draw
+    unsigned long getVerticesTransformed() const {
+        return m_verticesTransformed;
+    }
+
+private:
+    // A vertex after the vertex stage
+    struct ScreenVertex {
+        Vec2 position;
+        float depth;
+        float inverseW;
+        bool visible;
+    };
+
+    // Starts a new draw. A new generation marks everything cached by the last
+    // draw as stale, without having to clear the cache.
+    void newGeneration() {
+        ++m_generation;
+        if (m_generation == 0) {
+            std::fill(m_generations.begin(), m_generations.end(), 0);
+            m_generation = 1;
+        }
+    }
+
+    // Position of a vertex of the mesh
+    static Vec3 position(const float* vertices, unsigned int vertexSize, unsigned int index) {
+        const float* vertex = vertices + (size_t)index * vertexSize;
+        return Vec3(vertex[0], vertex[1], vertex[2]);
+    }
+
+    // The vertex stage: transforms a vertex to the screen, or fetches it from
+    // the cache if it has been already this draw
+    ScreenVertex transformVertex(const float* vertices, unsigned int vertexSize, unsigned int index,
+                                 const Mat4& transform) {
+        if (index >= m_cache.size()) {
+            m_cache.resize(index + 1);
+            m_generations.resize(index + 1, 0);
+        }
+
+        ScreenVertex& cached = m_cache[index];
+        if (m_generations[index] == m_generation) {
+            return cached;
+        }
+        m_generations[index] = m_generation;
+        ++m_verticesTransformed;
+
+        Vec4 clip = transform.transform(position(vertices, vertexSize, index));
+        cached.visible = clip.w > 0.0f && clip.z >= 0.0f && clip.z <= clip.w;
+        if (cached.visible) {
+            // Divide by w, then map -1 to 1 across the image, with up being up.
+            // Anything far enough off the image for the rasterizer to skip is
+            // clamped to just beyond its limit first, so it still fits in an int.
+            float inverseW = 1.0f / clip.w;
+            const float limit = RASTERIZER_MAX_COORDINATE + 1;
+            float x = (clip.x * inverseW + 1.0f) * 0.5f * m_image.getWidth();
+            float y = (1.0f - clip.y * inverseW) * 0.5f * m_image.getHeight();
+            cached.position = Vec2((int)std::floor(std::max(-limit, std::min(limit, x))),
+                                   (int)std::floor(std::max(-limit, std::min(limit, y))));
+            cached.depth = clip.z * inverseW;
+            cached.inverseW = inverseW;
+        }
+        return cached;
+    }
+
+    TGA& m_image;
+    DepthBuffer& m_depth;
+    Vec3 m_lightDirection{0.0f, 0.0f, 1.0f};
+
+    // The post-transform cache, and the draw each entry was filled by
+    std::vector<ScreenVertex> m_cache;
+    std::vector<unsigned int> m_generations;
+    unsigned int m_generation{0};
+    unsigned long m_verticesTransformed{0};
+};
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef MULTISAMPLE_BUFFER_H
+#define MULTISAMPLE_BUFFER_H
+
+/** @file MultisampleBuffer.h
+ *  @brief A multisampled color and depth buffer, resolved into a TGA image
+ *
+ *  Note this is implemented as a header only library.
+ *  This is to make this code easy to be shared.
+ *
+ *  Every pixel holds 4 or 8 samples, each with a color and a depth, at
+ *  fixed positions within the pixel. A triangle is tested for coverage at
+ *  every sample, but its color is worked out only once per pixel and then
+ *  stored into whichever samples it covers (see fillTriangleMultisample
+ *  in Rasterizer.h). Resolving averages each pixel's samples into an
+ *  image, so pixels along an edge take a blend of the colors on either
+ *  side of it.
+ *
+ *  Most pixels are covered entirely by a single triangle, and all of their
+ *  samples hold the same color. Such a pixel only has its first sample's
+ *  color stored, and is marked as uniform, until a triangle covers just
+ *  part of it. That keeps the color writes, and the work of resolving,
+ *  close to one per pixel away from edges.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <vector>
+
+// User libraries
+#include "Color.h"
+#include "TGA.h"
+
+// Vertices given to the multisampled fill are in fixed point, in units of
+// 1 / RASTERIZER_SUBPIXEL_SCALE of a pixel, as are the sample positions
+#define RASTERIZER_SUBPIXEL_BITS 4
+#define RASTERIZER_SUBPIXEL_SCALE (1 << RASTERIZER_SUBPIXEL_BITS)
+
+// The largest number of samples per pixel
+#define MULTISAMPLE_MAX_SAMPLES 8
+
+class MultisampleBuffer {
+public:
+
+    // Constructor
+    // samples is the number of samples per pixel, 4 or 8; anything other
+    // than 8 gives 4. Every sample starts out gray, at the far plane.
+    MultisampleBuffer(unsigned int width, unsigned int height, unsigned int samples)
+        : m_width(width), m_height(height), m_samples(samples == 8 ? 8 : 4) {
+        // The sample positions of Direct3D's standard patterns, in
+        // sixteenths of a pixel from its center. They are spread so that no
+        // two share a row or a column, which keeps nearly horizontal and
+        // nearly vertical edges from hitting them all at once.
+        static const int pattern4[4][2] = {{-2, -6}, {6, -2}, {-6, 2}, {2, 6}};
+        static const int pattern8[8][2] = {{1, -3}, {-1, 3}, {5, 1}, {-3, -5},
+                                           {-5, 5}, {-7, -1}, {3, 7}, {7, -7}};
+        const int (*pattern)[2] = m_samples == 8 ? pattern8 : pattern4;
+        for (unsigned int ss = 0; ss < m_samples; ++ss) {
+            m_sampleX[ss] = pattern[ss][0] * RASTERIZER_SUBPIXEL_SCALE / 16;
+            m_sampleY[ss] = pattern[ss][1] * RASTERIZER_SUBPIXEL_SCALE / 16;
+        }
+        m_fullMask = (1u << m_samples) - 1;
+
+        m_colors.resize(width * height * m_samples);
+        m_depth.resize(width * height * m_samples);
+        m_uniform.resize(width * height);
+        ColorRGB gray;
+        gray.r = gray.g = gray.b = 128;
+        clear(gray);
+    }
+
+    // Sets every sample back to the given color and depth
+    void clear(ColorRGB color, float depth = 1.0f) {
+        for (unsigned int ii = 0; ii < m_width * m_height; ++ii) {
+            m_colors[ii * m_samples] = color;
+        }
+        std::fill(m_uniform.begin(), m_uniform.end(), 1);
+        std::fill(m_depth.begin(), m_depth.end(), depth);
+    }
+
+    // Width of the buffer in pixels
+    unsigned int getWidth() const {
+        return m_width;
+    }
+
+    // Height of the buffer in pixels
+    unsigned int getHeight() const {
+        return m_height;
+    }
+
+    // Number of samples per pixel
+    unsigned int getSamples() const {
+        return m_samples;
+    }
+
+    // A mask with a bit set for every sample of a pixel
+    unsigned int getFullMask() const {
+        return m_fullMask;
+    }
+
+    // Position of a sample relative to the center of its pixel, in
+    // subpixel units
+    int getSampleX(unsigned int sample) const {
+        return m_sampleX[sample];
+    }
+
+    int getSampleY(unsigned int sample) const {
+        return m_sampleY[sample];
+    }
+
+    // Returns the depth of every sample, the samples of each pixel next to
+    // each other, a row of pixels at a time
+    float* getDepthData() {
+        return m_depth.data();
+    }
+
+    // Stores a color into the samples of a pixel that are set in mask
+    void writeSamples(unsigned int pixel, unsigned int mask, ColorRGB color) {
+        ColorRGB* samples = &m_colors[pixel * m_samples];
+        if (mask == m_fullMask) {
+            samples[0] = color;
+            m_uniform[pixel] = 1;
+            return;
+        }
+
+        // Only part of the pixel changes, so its samples can no longer share
+        // the first one's color
+        if (m_uniform[pixel]) {
+            std::fill(samples + 1, samples + m_samples, samples[0]);
+            m_uniform[pixel] = 0;
+        }
+        for (unsigned int ss = 0; ss < m_samples; ++ss) {
+            if (mask & (1u << ss)) {
+                samples[ss] = color;
+            }
+        }
+    }
+
+    // Averages the samples of every pixel into an image of the same size
+    void resolve(TGA& image) const {
+        unsigned char* pixel = image.getPixelData();
+        const unsigned int shift = m_samples == 8 ? 3 : 2;
+
+        for (unsigned int ii = 0; ii < m_width * m_height; ++ii, pixel += 3) {
+            const ColorRGB* samples = &m_colors[ii * m_samples];
+            if (m_uniform[ii]) {
+                pixel[0] = samples[0].r;
+                pixel[1] = samples[0].g;
+                pixel[2] = samples[0].b;
+                continue;
+            }
+
+            unsigned int r = 0, g = 0, b = 0;
+            for (unsigned int ss = 0; ss < m_samples; ++ss) {
+                r += samples[ss].r;
+                g += samples[ss].g;
+                b += samples[ss].b;
+            }
+            const unsigned int half = m_samples / 2;
+            pixel[0] = (unsigned char)((r + half) >> shift);
+            pixel[1] = (unsigned char)((g + half) >> shift);
+            pixel[2] = (unsigned char)((b + half) >> shift);
+        }
+    }
+
+private:
+    unsigned int m_width;
+    unsigned int m_height;
+    unsigned int m_samples;
+    unsigned int m_fullMask;
+    int m_sampleX[MULTISAMPLE_MAX_SAMPLES];
+    int m_sampleY[MULTISAMPLE_MAX_SAMPLES];
+    std::vector<ColorRGB> m_colors;
+    std::vector<float> m_depth;
+    std::vector<unsigned char> m_uniform;
+};
+
+#endif
@@ -0,0 +1,200 @@
+#ifndef OBJ_READER_H
+#define OBJ_READER_H
+
+/** @file ObjReader.h
+ *  @brief Reads the geometry out of .obj files
+ *
+ *  Note this is implemented as a header only library.
+ *  This is to make this code easy to be shared.
+ *
+ *  readObj reads only vertex positions ('v' lines) and faces ('f' lines),
+ *  skipping texture coordinates, normals and materials. readTexturedObj
+ *  reads texture coordinates and normals as well, and the diffuse texture
+ *  named by the material library. Faces with more than three vertices are
+ *  split into a fan of triangles.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// User libraries
+#include "Maths.h"
+
+// Reads the positions and triangles of an .obj file, with three indices
+// into positions per triangle. Returns false if the file cannot be opened
+// or a face refers to a position that does not exist.
+bool readObj(const std::string& fileName, std::vector<Vec3>& positions, std::vector<unsigned int>& indices) {
+    std::ifstream file(fileName.c_str());
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+
+        if (type == "v") {
+            Vec3 position;
+            stream >> position.x >> position.y >> position.z;
+            positions.push_back(position);
+        } else if (type == "f") {
+            // Each corner is "v", "v/vt", "v//vn" or "v/vt/vn"; only v is needed
+            std::vector<unsigned int> corners;
+            std::string corner;
+            while (stream >> corner) {
+                int index = std::atoi(corner.c_str());
+                // Negative indices count back from the most recent position
+                index = index < 0 ? (int)positions.size() + index : index - 1;
+                if (index < 0 || index >= (int)positions.size()) {
+                    return false;
+                }
+                corners.push_back(index);
+            }
+
+            for (unsigned int ii = 2; ii < corners.size(); ++ii) {
+                indices.push_back(corners[0]);
+                indices.push_back(corners[ii - 1]);
+                indices.push_back(corners[ii]);
+            }
+        }
+    }
+
+    return true;
+}
+
+// Finds the diffuse texture (map_Kd) of the first material library (mtllib)
+// an .obj file uses, as a path relative to the working directory, or an
+// empty string if there is none
+std::string readDiffuseMap(const std::string& fileName, const std::string& library) {
+    const size_t slash = fileName.find_last_of("/\\");
+    const std::string directory = slash == std::string::npos ? "" : fileName.substr(0, slash + 1);
+
+    std::ifstream file((directory + library).c_str());
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string type;
+        std::string path;
+        stream >> type >> path;
+        if (type == "map_Kd" && !path.empty()) {
+            return directory + path;
+        }
+    }
+    return "";
+}
+
+// Reads the triangles of an .obj file with their texture coordinates and
+// normals, into the vertex and index arrays MeshRenderer::drawIndexedTextured
+// takes. Each vertex is eight floats: x, y, z, u, v, and the normal's x, y
+// and z. Corners of faces that name the same position, texture coordinates
+// and normal share one vertex. A corner with no texture coordinates gets
+// (0, 0), and one with no normal gets its face's.
+//
+// diffuseMap is set to the path of the diffuse texture of the file's
+// material library, or emptied if it has none. Returns false if the file
+// cannot be opened or a face refers to something that does not exist.
+bool readTexturedObj(const std::string& fileName, std::vector<float>& vertices, std::vector<unsigned int>& indices,
+                     std::string& diffuseMap) {
+    std::ifstream file(fileName.c_str());
+    if (!file.is_open()) {
+        return false;
+    }
+    diffuseMap.clear();
+
+    std::vector<Vec3> positions;
+    std::vector<Vec3> coordinates;
+    std::vector<Vec3> normals;
+    std::map<std::string, unsigned int> shared;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string type;
+        stream >> type;
+
+        if (type == "v" || type == "vt" || type == "vn") {
+            Vec3 value;
+            stream >> value.x >> value.y >> value.z;
+            (type == "v" ? positions : type == "vt" ? coordinates : normals).push_back(value);
+        } else if (type == "mtllib" && diffuseMap.empty()) {
+            std::string library;
+            stream >> library;
+            diffuseMap = readDiffuseMap(fileName, library);
+        } else if (type == "f") {
+            // Each corner is "v", "v/vt", "v//vn" or "v/vt/vn", all counting
+            // from 1, or back from the most recent one if negative
+            std::vector<std::string> names;
+            std::vector<int> corners[3];
+            std::string corner;
+            while (stream >> corner) {
+                const std::vector<Vec3>* lists[3] = {&positions, &coordinates, &normals};
+                size_t begin = 0;
+                for (int part = 0; part < 3; ++part) {
+                    size_t end = corner.find('/', begin);
+                    std::string number = corner.substr(begin, end == std::string::npos ? end : end - begin);
+                    int index = -1;
+                    if (!number.empty()) {
+                        index = std::atoi(number.c_str());
+                        index = index < 0 ? (int)lists[part]->size() + index : index - 1;
+                        if (index < 0 || index >= (int)lists[part]->size()) {
+                            return false;
+                        }
+                    } else if (part == 0) {
+                        return false;
+                    }
+                    corners[part].push_back(index);
+                    begin = end == std::string::npos ? corner.size() : end + 1;
+                }
+                names.push_back(corner);
+            }
+            if (names.size() < 3) {
+                continue;
+            }
+
+            const Vec3 faceNormal = (positions[corners[0][1]] - positions[corners[0][0]])
+                                        .cross(positions[corners[0][2]] - positions[corners[0][0]]).normalized();
+            std::vector<unsigned int> faceVertices;
+            for (unsigned int ii = 0; ii < names.size(); ++ii) {
+                // A corner that takes its face's normal cannot be shared
+                // with other faces
+                const bool hasNormal = corners[2][ii] >= 0;
+                const std::string key = hasNormal ? names[ii] : names[ii] + "#" + std::to_string(indices.size());
+                std::map<std::string, unsigned int>::iterator found = shared.find(key);
+                if (found != shared.end()) {
+                    faceVertices.push_back(found->second);
+                    continue;
+                }
+
+                const Vec3& position = positions[corners[0][ii]];
+                const Vec3 coordinate = corners[1][ii] >= 0 ? coordinates[corners[1][ii]] : Vec3();
+                const Vec3& normal = hasNormal ? normals[corners[2][ii]] : faceNormal;
+                const float vertex[8] = {position.x, position.y, position.z, coordinate.x, coordinate.y,
+                                         normal.x, normal.y, normal.z};
+                const unsigned int index = vertices.size() / 8;
+                vertices.insert(vertices.end(), vertex, vertex + 8);
+                shared[key] = index;
+                faceVertices.push_back(index);
+            }
+
+            for (unsigned int ii = 2; ii < faceVertices.size(); ++ii) {
+                indices.push_back(faceVertices[0]);
+                indices.push_back(faceVertices[ii - 1]);
+                indices.push_back(faceVertices[ii]);
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif
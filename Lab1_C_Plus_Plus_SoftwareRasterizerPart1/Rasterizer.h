@@ -0,0 +1,1127 @@
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+/** @file Rasterizer.h
+ *  @brief Functions for drawing lines and triangles onto a TGA image
+ *
+ *  Note this is implemented as a header only library.
+ *  This is to make this code easy to be shared.
+ *
+ *  The shape that gets drawn for a triangle depends on the fill mode
+ *  (see GL.h):
+ *
+ *  LINE       draws the three edges, clipped to the image.
+ *  FILL       tests every pixel of the bounding box with insideOfTriangle.
+ *  FILL_EDGE  steps integer edge functions down the bounding box a row
+ *             at a time, keeping track of where each crosses zero, and
+ *             fills the run of pixels in between, so no pixel is tested
+ *             on its own and each step needs only additions.
+ *  FILL_BLOCK steps the same edge functions across the bounding box eight
+ *             pixels at a time, finding which of the eight are inside at
+ *             once, and writes them with one masked store. Compiled with
+ *             AVX2 enabled (e.g. -mavx2) the eight are evaluated in the
+ *             lanes of one register; otherwise in a plain loop.
+ *
+ *  fillTriangleDepth fills a triangle with a depth test against a
+ *  DepthBuffer (see DepthBuffer.h), whatever the fill mode.
+ *
+ *  fillTriangleMultisample fills a triangle into a MultisampleBuffer (see
+ *  MultisampleBuffer.h) for anti-aliased edges, from vertices placed to a
+ *  fraction of a pixel.
+ *
+ *  fillTriangleTextured fills a triangle with a Texture (see Texture.h),
+ *  lit by normals interpolated across it, with a depth test.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// User libraries
+#include "GL.h"
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "DepthBuffer.h"
+#include "MultisampleBuffer.h"
+#include "Texture.h"
+
+// Width in pixels of the blocks FILL_BLOCK works on
+#define RASTERIZER_BLOCK_WIDTH 8
+
+// Vertices beyond this many pixels from the origin are skipped by FILL_EDGE,
+// as its edge functions would no longer fit in an int
+#define RASTERIZER_MAX_COORDINATE 8191
+
+// Divides, rounding towards negative infinity rather than towards zero.
+// The divisor must be positive.
+int floorDivide(int numerator, int divisor) {
+    int quotient = numerator / divisor;
+    if (numerator % divisor != 0 && numerator < 0) {
+        --quotient;
+    }
+    return quotient;
+}
+
+// As above, for numbers too large for an int
+long long floorDivide(long long numerator, long long divisor) {
+    long long quotient = numerator / divisor;
+    if (numerator % divisor != 0 && numerator < 0) {
+        --quotient;
+    }
+    return quotient;
+}
+
+// Outcodes for Cohen-Sutherland line clipping: a bit for each side of the
+// clip rectangle that a point lies beyond
+#define CLIP_LEFT 1
+#define CLIP_RIGHT 2
+#define CLIP_TOP 4
+#define CLIP_BOTTOM 8
+
+// Lines are first cut down to this many pixels around the clip rectangle,
+// which keeps the sums drawLine does to clip exactly within a long long
+#define RASTERIZER_LINE_GUARD (1 << 24)
+
+// Gives the outcode of a point against the rectangle from clipMin to
+// clipMax (inclusive)
+int clipOutcode(Vec2 v, Vec2 clipMin, Vec2 clipMax) {
+    int code = 0;
+    if (v.x < clipMin.x) {
+        code |= CLIP_LEFT;
+    } else if (v.x > clipMax.x) {
+        code |= CLIP_RIGHT;
+    }
+    if (v.y < clipMin.y) {
+        code |= CLIP_TOP;
+    } else if (v.y > clipMax.y) {
+        code |= CLIP_BOTTOM;
+    }
+    return code;
+}
+
+// Clips the line from v0 to v1 to the rectangle from clipMin to clipMax
+// (inclusive) with the Cohen-Sutherland algorithm: while an end lies
+// outside, it is moved along the line onto the side it lies beyond,
+// rounding to the nearest pixel. Returns false if no part of the line is
+// left.
+bool clipLine(Vec2& v0, Vec2& v1, Vec2 clipMin, Vec2 clipMax) {
+    int code0 = clipOutcode(v0, clipMin, clipMax);
+    int code1 = clipOutcode(v1, clipMin, clipMax);
+
+    while (true) {
+        if ((code0 | code1) == 0) {
+            return true;
+        }
+        if ((code0 & code1) != 0) {
+            // Both ends lie beyond the same side
+            return false;
+        }
+
+        const int code = code0 != 0 ? code0 : code1;
+        const long long dx = (long long)v1.x - v0.x;
+        const long long dy = (long long)v1.y - v0.y;
+        Vec2 moved;
+        if (code & (CLIP_TOP | CLIP_BOTTOM)) {
+            moved.y = (code & CLIP_TOP) ? clipMin.y : clipMax.y;
+            moved.x = v0.x + (int)std::llround((double)dx * (moved.y - v0.y) / dy);
+        } else {
+            moved.x = (code & CLIP_LEFT) ? clipMin.x : clipMax.x;
+            moved.y = v0.y + (int)std::llround((double)dy * (moved.x - v0.x) / dx);
+        }
+
+        if (code == code0) {
+            v0 = moved;
+            code0 = clipOutcode(v0, clipMin, clipMax);
+        } else {
+            v1 = moved;
+            code1 = clipOutcode(v1, clipMin, clipMax);
+        }
+    }
+}
+
+// Implementation of Bresenham's Line Algorithm
+// The input to this algorithm is two points and a color
+// This algorithm will then modify a canvas (i.e. image)
+// filling in the appropriate colors.
+//
+// The line is walked one pixel at a time along its longer (major) axis,
+// keeping an integer error term that says when to also step along the
+// shorter (minor) one, so there is no division or floating point per
+// pixel. Only pixels within the rectangle from clipMin to clipMax
+// (inclusive), which must lie within the image, are drawn: the outcodes
+// of the ends reject lines wholly beyond one side, and for lines that
+// cross the rectangle the first and last steps inside it are worked out
+// exactly, so the pixels drawn are the same as if the whole line were
+// drawn on a larger image.
+void drawLine(Vec2 v0, Vec2 v1, TGA& image, ColorRGB color, Vec2 clipMin, Vec2 clipMax) {
+    const int code0 = clipOutcode(v0, clipMin, clipMax);
+    const int code1 = clipOutcode(v1, clipMin, clipMax);
+    if ((code0 & code1) != 0) {
+        return;
+    }
+
+    // Very long lines are cut down first, so nothing below can overflow
+    const Vec2 guard(RASTERIZER_LINE_GUARD, RASTERIZER_LINE_GUARD);
+    if (!clipLine(v0, v1, clipMin - guard, clipMax + guard)) {
+        return;
+    }
+
+    const bool xMajor = std::abs(v1.x - v0.x) >= std::abs(v1.y - v0.y);
+    const int majorStart = xMajor ? v0.x : v0.y;
+    const int minorStart = xMajor ? v0.y : v0.x;
+    const int majorDelta = xMajor ? v1.x - v0.x : v1.y - v0.y;
+    const int minorDelta = xMajor ? v1.y - v0.y : v1.x - v0.x;
+    const int majorSign = majorDelta >= 0 ? 1 : -1;
+    const int minorSign = minorDelta >= 0 ? 1 : -1;
+    const long long length = std::abs(majorDelta);
+    const long long width = std::abs(minorDelta);
+
+    // After step i the line has moved floor((i * width + bias) / length)
+    // pixels along the minor axis
+    const long long bias = length - 1 - length / 2;
+
+    long long first = 0;
+    long long last = length;
+    if ((code0 | code1) != 0) {
+        // Keep the steps where the major coordinate lies inside...
+        const int majorMin = xMajor ? clipMin.x : clipMin.y;
+        const int majorMax = xMajor ? clipMax.x : clipMax.y;
+        first = std::max(first, majorSign > 0 ? (long long)majorMin - majorStart : (long long)majorStart - majorMax);
+        last = std::min(last, majorSign > 0 ? (long long)majorMax - majorStart : (long long)majorStart - majorMin);
+
+        // ...and the minor coordinate too, as distances along the line
+        const int minorMin = xMajor ? clipMin.y : clipMin.x;
+        const int minorMax = xMajor ? clipMax.y : clipMax.x;
+        const long long nearest = minorSign > 0 ? (long long)minorMin - minorStart : (long long)minorStart - minorMax;
+        const long long farthest = minorSign > 0 ? (long long)minorMax - minorStart : (long long)minorStart - minorMin;
+        if (width == 0) {
+            if (nearest > 0 || farthest < 0) {
+                return;
+            }
+        } else {
+            first = std::max(first, -floorDivide(bias - nearest * length, width));
+            last = std::min(last, floorDivide((farthest + 1) * length - 1 - bias, width));
+        }
+
+        if (first > last) {
+            return;
+        }
+    }
+
+    const int pitch = image.getWidth() * 3;
+    const int majorStep = xMajor ? 3 * majorSign : pitch * majorSign;
+    const int minorStep = xMajor ? pitch * minorSign : 3 * minorSign;
+
+    // Pick the walk up at the first step inside
+    long long minorOffset = length == 0 ? 0 : floorDivide(first * width + bias, length);
+    int error = (int)(length / 2 - first * width + minorOffset * length);
+    int major = majorStart + majorSign * (int)first;
+    int minor = minorStart + minorSign * (int)minorOffset;
+    unsigned char* pixel = image.getPixelData() + ((xMajor ? minor : major) * image.getWidth() + (xMajor ? major : minor)) * 3;
+
+    for (long long ii = first; ; ++ii) {
+        pixel[0] = color.r;
+        pixel[1] = color.g;
+        pixel[2] = color.b;
+        if (ii == last) {
+            break;
+        }
+
+        pixel += majorStep;
+        error -= (int)width;
+        if (error < 0) {
+            pixel += minorStep;
+            error += (int)length;
+        }
+    }
+}
+
+// Draws a line as above, clipped to the image
+void drawLine(Vec2 v0, Vec2 v1, TGA& image, ColorRGB color) {
+    drawLine(v0, v1, image, color, Vec2(0, 0), Vec2(image.getWidth() - 1, image.getHeight() - 1));
+}
+
+// Draws a batch of lines of one color, from vertices[0] to vertices[1],
+// vertices[2] to vertices[3] and so on, as GL_LINES would. count is the
+// number of vertices; an odd one out at the end is ignored.
+void drawLines(const Vec2* vertices, size_t count, TGA& image, ColorRGB color) {
+    const Vec2 clipMin(0, 0);
+    const Vec2 clipMax(image.getWidth() - 1, image.getHeight() - 1);
+    for (size_t ii = 0; ii + 1 < count; ii += 2) {
+        drawLine(vertices[ii], vertices[ii + 1], image, color, clipMin, clipMax);
+    }
+}
+
+// Tells if the given coordinates lie inside of the triangle (or on one of the
+// edges) defined by the three given vectors
+bool insideOfTriangle(Vec2& pos, Vec2& v0, Vec2& v1, Vec2& v2) {
+    // Calculate relative position to v0 of all other vectors
+    Vec2 pos0 = pos - v0;
+    Vec2 v10 = v1 - v0;
+    Vec2 v20 = v2 - v0;
+
+    // Calculate components of the projection of pos onto v0 and v1
+    double numerator = (pos0.y * v20.x) - (pos0.x * v20.y);
+    double denominator = (v10.y * v20.x) - (v10.x * v20.y);
+    double w0 = numerator / denominator;
+
+    double w1 = (pos0.y - (w0 * v10.y)) / v20.y;
+
+    // pos is inside the triangle if:
+    //  - w0 >= 0
+    //  - w1 >= 0
+    //  - w0 + w1 <= 1
+
+    return (w0 >= 0) && (w1 >= 0) && (w0 + w1 <= 1);
+}
+
+// An edge function for the edge from a to b.
+//
+// Evaluated at a point p, the edge function is
+//     (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x)
+// which is twice the signed area of the triangle a, b, p. It is zero on the
+// edge, and positive on the side the triangle's third vertex is on once the
+// triangle has been put in a consistent winding order. Written as
+//     stepX * p.x + stepY * p.y + offset
+// moving one pixel right adds stepX, and moving one pixel down adds stepY.
+struct EdgeFunction {
+    int stepX;
+    int stepY;
+    int offset;
+
+    EdgeFunction(const Vec2& a, const Vec2& b) {
+        stepX = a.y - b.y;
+        stepY = b.x - a.x;
+        offset = a.x * b.y - a.y * b.x;
+
+        // The top-left fill rule: a pixel lying exactly on an edge shared by
+        // two triangles belongs to only one of them. Pixels on a left edge
+        // (one the inside lies to the right of) or a top edge (a horizontal
+        // one the inside lies below) are kept; the bias turns the >= 0 test
+        // into a > 0 test for every other edge.
+        bool isTopLeft = stepX > 0 || (stepX == 0 && stepY > 0);
+        if (!isTopLeft) {
+            offset -= 1;
+        }
+    }
+
+    // Value at the given pixel, including the fill rule bias
+    int at(int x, int y) const {
+        return stepX * x + stepY * y + offset;
+    }
+};
+
+// Sets count consecutive pixels of a row to one color, four pixels
+// (twelve bytes) at a time
+void fillSpan(unsigned char* pixel, int count, ColorRGB color) {
+    unsigned char pattern[12];
+    for (int ii = 0; ii < 12; ii += 3) {
+        pattern[ii] = color.r;
+        pattern[ii + 1] = color.g;
+        pattern[ii + 2] = color.b;
+    }
+
+    int ii = 0;
+    for (; ii + 4 <= count; ii += 4) {
+        memcpy(pixel + ii * 3, pattern, 12);
+    }
+    for (; ii < count; ++ii) {
+        memcpy(pixel + ii * 3, pattern, 3);
+    }
+}
+
+// Tracks where along each row an edge function crosses zero, from one row to
+// the next, using only additions.
+//
+// Along a row the edge function goes value, value + stepX, value + 2 stepX,
+// ..., so it is non-negative from pixel -floor(value / stepX) onwards when
+// stepX is positive, and up to pixel floor(value / -stepX) when negative.
+// Moving down a row adds stepY to value, so floor(value / |stepX|) can be
+// kept up to date as a quotient and remainder, the way Bresenham's line
+// algorithm keeps track of its error term.
+struct EdgeCrossing {
+    int stepX;
+    int value;
+    int quotient;
+    int remainder;
+    int quotientStep;
+    int remainderStep;
+
+    // Starts at the given value of the edge function at the start of a row
+    EdgeCrossing(const EdgeFunction& edge, int startValue) {
+        stepX = edge.stepX;
+        value = startValue;
+        // An edge with no slope along the row never crosses zero within it,
+        // and leaves these unused
+        quotient = remainder = quotientStep = remainderStep = 0;
+        if (stepX != 0) {
+            int divisor = std::abs(stepX);
+            quotient = floorDivide(value, divisor);
+            remainder = value - quotient * divisor;
+            quotientStep = floorDivide(edge.stepY, divisor);
+            remainderStep = edge.stepY - quotientStep * divisor;
+        }
+    }
+
+    // Narrows [first, last] down to the pixels of the current row where the
+    // edge function is non-negative
+    void clip(int& first, int& last) const {
+        if (stepX > 0) {
+            first = std::max(first, -quotient);
+        } else if (stepX < 0) {
+            last = std::min(last, quotient);
+        } else if (value < 0) {
+            last = -1;
+        }
+    }
+
+    // Moves down to the next row
+    void nextRow(int stepY) {
+        value += stepY;
+        if (stepX != 0) {
+            quotient += quotientStep;
+            remainder += remainderStep;
+            if (remainder >= std::abs(stepX)) {
+                remainder -= std::abs(stepX);
+                ++quotient;
+            }
+        }
+    }
+};
+
+// Gets a triangle ready for the edge function fill modes: puts its vertices
+// in the winding order that makes the inside of every edge function
+// positive, and finds its bounding box within the clip rectangle. Returns
+// false if there is nothing to draw.
+bool setUpTriangle(Vec2& v0, Vec2& v1, Vec2& v2, Vec2 clipMin, Vec2 clipMax, Vec2& boxMin, Vec2& boxMax) {
+    const Vec2* vertices[3] = {&v0, &v1, &v2};
+    for (const Vec2* vertex : vertices) {
+        if (std::abs(vertex->x) > RASTERIZER_MAX_COORDINATE || std::abs(vertex->y) > RASTERIZER_MAX_COORDINATE) {
+            return false;
+        }
+    }
+
+    int area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (area == 0) {
+        return false;
+    }
+    if (area < 0) {
+        std::swap(v1, v2);
+    }
+
+    // Clamp the bounding box to the clip rectangle, so nothing offscreen gets visited
+    boxMin = v0.min(v1.min(v2)).max(clipMin);
+    boxMax = v0.max(v1.max(v2)).min(clipMax);
+    return boxMin.x <= boxMax.x && boxMin.y <= boxMax.y;
+}
+
+// Fills a triangle by stepping its three edge functions down the bounding
+// box, one row at a time, writing every pixel where all three are
+// non-negative. Pixels are sampled at their integer coordinates, like
+// insideOfTriangle does.
+//
+// Only pixels within the rectangle from clipMin to clipMax (inclusive),
+// which must lie within the image, are written.
+void fillTriangleEdge(Vec2 v0, Vec2 v1, Vec2 v2, TGA& image, ColorRGB color, Vec2 clipMin, Vec2 clipMax) {
+    Vec2 boxMin, boxMax;
+    if (!setUpTriangle(v0, v1, v2, clipMin, clipMax, boxMin, boxMax)) {
+        return;
+    }
+    const int minX = boxMin.x, minY = boxMin.y, maxX = boxMax.x, maxY = boxMax.y;
+
+    // Each edge function is zero along the edge opposite one vertex
+    EdgeFunction e0(v1, v2);
+    EdgeFunction e1(v2, v0);
+    EdgeFunction e2(v0, v1);
+
+    EdgeCrossing c0(e0, e0.at(minX, minY));
+    EdgeCrossing c1(e1, e1.at(minX, minY));
+    EdgeCrossing c2(e2, e2.at(minX, minY));
+
+    unsigned char* row = image.getPixelData() + (minY * image.getWidth() + minX) * 3;
+    const unsigned int pitch = image.getWidth() * 3;
+
+    for (int yy = minY; yy <= maxY; ++yy) {
+        // A pixel is inside when all three edge functions are non-negative.
+        // A triangle covers one run of pixels per row, so rather than test
+        // every pixel, fill between where the edge functions cross zero.
+        int first = 0;
+        int last = maxX - minX;
+        c0.clip(first, last);
+        c1.clip(first, last);
+        c2.clip(first, last);
+        if (first <= last) {
+            fillSpan(row + first * 3, last - first + 1, color);
+        }
+
+        c0.nextRow(e0.stepY);
+        c1.nextRow(e1.stepY);
+        c2.nextRow(e2.stepY);
+        row += pitch;
+    }
+}
+
+// Fills a triangle as above, anywhere within the image
+void fillTriangleEdge(Vec2 v0, Vec2 v1, Vec2 v2, TGA& image, ColorRGB color) {
+    fillTriangleEdge(v0, v1, v2, image, color, Vec2(0, 0), Vec2(image.getWidth() - 1, image.getHeight() - 1));
+}
+
+#if defined(__AVX2__)
+// Byte masks selecting the pixels of an 8 pixel (24 byte) block, one for
+// every combination of pixels, indexed by a mask with one bit per pixel
+struct BlockByteMasks {
+    unsigned char masks[256][32];
+
+    BlockByteMasks() {
+        memset(masks, 0, sizeof(masks));
+        for (int mask = 0; mask < 256; ++mask) {
+            for (int pixel = 0; pixel < RASTERIZER_BLOCK_WIDTH; ++pixel) {
+                if (mask & (1 << pixel)) {
+                    memset(&masks[mask][pixel * 3], 0xFF, 3);
+                }
+            }
+        }
+    }
+};
+#endif
+
+// Fills a triangle a block of eight pixels at a time. For every block of
+// a row of the bounding box, the edge functions are evaluated at all eight
+// pixels at once, and the pixels found inside are written together, so
+// there is no branch per pixel.
+//
+// Only pixels within the rectangle from clipMin to clipMax (inclusive),
+// which must lie within the image, are written.
+void fillTriangleBlock(Vec2 v0, Vec2 v1, Vec2 v2, TGA& image, ColorRGB color, Vec2 clipMin, Vec2 clipMax) {
+    Vec2 boxMin, boxMax;
+    if (!setUpTriangle(v0, v1, v2, clipMin, clipMax, boxMin, boxMax)) {
+        return;
+    }
+    const int minX = boxMin.x, minY = boxMin.y, maxX = boxMax.x, maxY = boxMax.y;
+
+    EdgeFunction e0(v1, v2);
+    EdgeFunction e1(v2, v0);
+    EdgeFunction e2(v0, v1);
+
+    int row0 = e0.at(minX, minY);
+    int row1 = e1.at(minX, minY);
+    int row2 = e2.at(minX, minY);
+
+    unsigned char* row = image.getPixelData() + (minY * image.getWidth() + minX) * 3;
+    const unsigned int pitch = image.getWidth() * 3;
+    const int width = maxX - minX + 1;
+
+    // Eight pixels of color, to copy the covered ones out of
+    unsigned char pattern[32];
+    for (int ii = 0; ii < 32; ii += 3) {
+        pattern[ii] = color.r;
+        pattern[ii + 1] = color.g;
+        if (ii + 2 < 32) {
+            pattern[ii + 2] = color.b;
+        }
+    }
+
+#if defined(__AVX2__)
+    static const BlockByteMasks byteMasks;
+
+    // Each lane holds one pixel's edge function: value + stepX * lane
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i laneSteps0 = _mm256_mullo_epi32(_mm256_set1_epi32(e0.stepX), lanes);
+    const __m256i laneSteps1 = _mm256_mullo_epi32(_mm256_set1_epi32(e1.stepX), lanes);
+    const __m256i laneSteps2 = _mm256_mullo_epi32(_mm256_set1_epi32(e2.stepX), lanes);
+    const __m256i blockStep0 = _mm256_set1_epi32(e0.stepX * RASTERIZER_BLOCK_WIDTH);
+    const __m256i blockStep1 = _mm256_set1_epi32(e1.stepX * RASTERIZER_BLOCK_WIDTH);
+    const __m256i blockStep2 = _mm256_set1_epi32(e2.stepX * RASTERIZER_BLOCK_WIDTH);
+
+    // A whole block is 24 bytes, six of the eight 32-bit lanes. Loading and
+    // storing only those six never touches pixels beyond the block, which may
+    // belong to another thread's tile.
+    const __m256i blockLanes = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+    const __m256i colors = _mm256_loadu_si256((const __m256i*)pattern);
+
+    for (int yy = minY; yy <= maxY; ++yy) {
+        __m256i w0 = _mm256_add_epi32(_mm256_set1_epi32(row0), laneSteps0);
+        __m256i w1 = _mm256_add_epi32(_mm256_set1_epi32(row1), laneSteps1);
+        __m256i w2 = _mm256_add_epi32(_mm256_set1_epi32(row2), laneSteps2);
+
+        for (int xx = 0; xx < width; xx += RASTERIZER_BLOCK_WIDTH) {
+            // A pixel is inside when no edge function has its sign bit set
+            __m256i outside = _mm256_or_si256(w0, _mm256_or_si256(w1, w2));
+            unsigned int mask = ~_mm256_movemask_ps(_mm256_castsi256_ps(outside)) & 0xFF;
+            if (width - xx < RASTERIZER_BLOCK_WIDTH) {
+                // The last block of a row can be narrower, and can end partway
+                // through a lane, so its pixels are written one at a time
+                mask &= (1u << (width - xx)) - 1;
+                for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+                    if (mask & 1) {
+                        memcpy(row + (xx + lane) * 3, pattern, 3);
+                    }
+                }
+            } else if (mask != 0) {
+                int* pixels = (int*)(row + xx * 3);
+                __m256i byteMask = _mm256_loadu_si256((const __m256i*)byteMasks.masks[mask]);
+                __m256i current = _mm256_maskload_epi32(pixels, blockLanes);
+                _mm256_maskstore_epi32(pixels, blockLanes, _mm256_blendv_epi8(current, colors, byteMask));
+            }
+
+            w0 = _mm256_add_epi32(w0, blockStep0);
+            w1 = _mm256_add_epi32(w1, blockStep1);
+            w2 = _mm256_add_epi32(w2, blockStep2);
+        }
+
+        row0 += e0.stepY;
+        row1 += e1.stepY;
+        row2 += e2.stepY;
+        row += pitch;
+    }
+#else
+    for (int yy = minY; yy <= maxY; ++yy) {
+        int block0 = row0;
+        int block1 = row1;
+        int block2 = row2;
+
+        for (int xx = 0; xx < width; xx += RASTERIZER_BLOCK_WIDTH) {
+            int count = std::min(RASTERIZER_BLOCK_WIDTH, width - xx);
+
+            // Find every pixel of the block inside, then write them all
+            unsigned int mask = 0;
+            for (int lane = 0; lane < count; ++lane) {
+                int outside = (block0 + e0.stepX * lane) | (block1 + e1.stepX * lane) | (block2 + e2.stepX * lane);
+                mask |= (unsigned int)(outside >= 0) << lane;
+            }
+
+            if (mask == (1u << count) - 1) {
+                memcpy(row + xx * 3, pattern, count * 3);
+            } else {
+                for (int lane = 0; mask != 0; ++lane, mask >>= 1) {
+                    if (mask & 1) {
+                        memcpy(row + (xx + lane) * 3, pattern, 3);
+                    }
+                }
+            }
+
+            block0 += e0.stepX * RASTERIZER_BLOCK_WIDTH;
+            block1 += e1.stepX * RASTERIZER_BLOCK_WIDTH;
+            block2 += e2.stepX * RASTERIZER_BLOCK_WIDTH;
+        }
+
+        row0 += e0.stepY;
+        row1 += e1.stepY;
+        row2 += e2.stepY;
+        row += pitch;
+    }
+#endif
+}
+
+// Fills a triangle as above, anywhere within the image
+void fillTriangleBlock(Vec2 v0, Vec2 v1, Vec2 v2, TGA& image, ColorRGB color) {
+    fillTriangleBlock(v0, v1, v2, image, color, Vec2(0, 0), Vec2(image.getWidth() - 1, image.getHeight() - 1));
+}
+
+// Fills a triangle with a depth test against the given depth buffer: a
+// pixel is written only if the triangle is nearer there than whatever was
+// drawn before, and its depth is then stored. z0, z1 and z2 are the depths
+// of the vertices, from 0 at the near plane to 1 at the far plane (see
+// depthFromDistance), which change linearly across the screen and so are
+// interpolated between the vertices as a plane.
+//
+// The runs of covered pixels are found as in FILL_EDGE, then drawn one
+// depth tile at a time. A tile is skipped without looking at its pixels
+// if the triangle's nearest depth over it is no nearer than the farthest
+// pixel already drawn there.
+//
+// Only pixels within the rectangle from clipMin to clipMax (inclusive),
+// which must lie within the image, are written. Returns how many were.
+unsigned int fillTriangleDepth(Vec2 v0, Vec2 v1, Vec2 v2, float z0, float z1, float z2, TGA& image,
+                               DepthBuffer& depth, ColorRGB color, Vec2 clipMin, Vec2 clipMax) {
+    // Put the vertices in order here rather than in setUpTriangle, so the
+    // depths stay with their vertices
+    int area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (area < 0) {
+        std::swap(v1, v2);
+        std::swap(z1, z2);
+        area = -area;
+    }
+
+    Vec2 boxMin, boxMax;
+    if (!setUpTriangle(v0, v1, v2, clipMin, clipMax, boxMin, boxMax)) {
+        return 0;
+    }
+
+    EdgeFunction e0(v1, v2);
+    EdgeFunction e1(v2, v0);
+    EdgeFunction e2(v0, v1);
+
+    EdgeCrossing c0(e0, e0.at(boxMin.x, boxMin.y));
+    EdgeCrossing c1(e1, e1.at(boxMin.x, boxMin.y));
+    EdgeCrossing c2(e2, e2.at(boxMin.x, boxMin.y));
+
+    // The depth plane: each edge function divided by the area is the weight
+    // of the vertex opposite it
+    const float dzdx = (e0.stepX * z0 + e1.stepX * z1 + e2.stepX * z2) / area;
+    const float dzdy = (e0.stepY * z0 + e1.stepY * z1 + e2.stepY * z2) / area;
+    const float nearest = std::min(z0, std::min(z1, z2));
+
+    unsigned char* pixels = image.getPixelData();
+    float* depths = depth.getDepthData();
+    const int width = image.getWidth();
+    unsigned int written = 0;
+
+    // The run of pixels covered in each row of the current band, as in
+    // FILL_EDGE, from boxMin.x
+    int first[DEPTH_TILE_SIZE];
+    int last[DEPTH_TILE_SIZE];
+
+    for (int bandY = boxMin.y / DEPTH_TILE_SIZE * DEPTH_TILE_SIZE; bandY <= boxMax.y; bandY += DEPTH_TILE_SIZE) {
+        const int minY = std::max(bandY, boxMin.y);
+        const int maxY = std::min(bandY + DEPTH_TILE_SIZE - 1, boxMax.y);
+
+        // Find the runs of the band's rows, and the columns they span between them
+        int bandFirst = boxMax.x - boxMin.x;
+        int bandLast = 0;
+        for (int yy = minY; yy <= maxY; ++yy) {
+            int& rowFirst = first[yy - minY];
+            int& rowLast = last[yy - minY];
+            rowFirst = 0;
+            rowLast = boxMax.x - boxMin.x;
+            c0.clip(rowFirst, rowLast);
+            c1.clip(rowFirst, rowLast);
+            c2.clip(rowFirst, rowLast);
+            if (rowFirst <= rowLast) {
+                bandFirst = std::min(bandFirst, rowFirst);
+                bandLast = std::max(bandLast, rowLast);
+            }
+
+            c0.nextRow(e0.stepY);
+            c1.nextRow(e1.stepY);
+            c2.nextRow(e2.stepY);
+        }
+        if (bandFirst > bandLast) {
+            continue;
+        }
+        bandFirst += boxMin.x;
+        bandLast += boxMin.x;
+
+        for (int tileX = bandFirst / DEPTH_TILE_SIZE * DEPTH_TILE_SIZE; tileX <= bandLast; tileX += DEPTH_TILE_SIZE) {
+            const int minX = std::max(tileX, bandFirst);
+            const int maxX = std::min(tileX + DEPTH_TILE_SIZE - 1, bandLast);
+
+            // The depth plane is nearest at one corner of the part of the tile
+            // the triangle spans, though never nearer than the nearest vertex.
+            // If even that is no nearer than everything already drawn in the
+            // tile, none of the triangle shows through.
+            float tileNearest = z0 + dzdx * ((dzdx > 0 ? minX : maxX) - v0.x) +
+                                dzdy * ((dzdy > 0 ? minY : maxY) - v0.y);
+            const float tileMax = depth.getTileMax(minX, minY);
+            if (std::max(tileNearest, nearest) >= tileMax) {
+                continue;
+            }
+
+            // The tile's farthest depth can only change if a pixel at that
+            // depth is drawn over
+            bool farthestDrawn = false;
+            for (int yy = minY; yy <= maxY; ++yy) {
+                const int spanFirst = std::max(minX, first[yy - minY] + boxMin.x);
+                const int spanLast = std::min(maxX, last[yy - minY] + boxMin.x);
+                float zz = z0 + dzdx * (spanFirst - v0.x) + dzdy * (yy - v0.y);
+                float* depthRow = depths + yy * width;
+                unsigned char* pixelRow = pixels + yy * width * 3;
+
+                for (int xx = spanFirst; xx <= spanLast; ++xx, zz += dzdx) {
+                    if (zz < depthRow[xx]) {
+                        farthestDrawn |= depthRow[xx] == tileMax;
+                        depthRow[xx] = zz;
+                        pixelRow[xx * 3] = color.r;
+                        pixelRow[xx * 3 + 1] = color.g;
+                        pixelRow[xx * 3 + 2] = color.b;
+                        ++written;
+                    }
+                }
+            }
+
+            if (farthestDrawn) {
+                depth.updateTileMax(minX, minY);
+            }
+        }
+    }
+
+    return written;
+}
+
+// Fills a triangle with a depth test as above, anywhere within the image
+unsigned int fillTriangleDepth(Vec2 v0, Vec2 v1, Vec2 v2, float z0, float z1, float z2, TGA& image,
+                               DepthBuffer& depth, ColorRGB color) {
+    return fillTriangleDepth(v0, v1, v2, z0, z1, z2, image, depth, color, Vec2(0, 0),
+                             Vec2(image.getWidth() - 1, image.getHeight() - 1));
+}
+
+// An edge function as in EdgeFunction, for vertices in subpixel units
+// (see MultisampleBuffer.h). At that scale its values no longer fit in an
+// int, so they are kept in long longs.
+struct SubpixelEdgeFunction {
+    long long stepX;
+    long long stepY;
+    long long offset;
+
+    SubpixelEdgeFunction(const Vec2& a, const Vec2& b) {
+        stepX = a.y - b.y;
+        stepY = b.x - a.x;
+        offset = (long long)a.x * b.y - (long long)a.y * b.x;
+
+        // The same top-left fill rule, so a sample lying exactly on an edge
+        // shared by two triangles belongs to only one of them
+        bool isTopLeft = stepX > 0 || (stepX == 0 && stepY > 0);
+        if (!isTopLeft) {
+            offset -= 1;
+        }
+    }
+
+    // Value at the given point, including the fill rule bias
+    long long at(long long x, long long y) const {
+        return stepX * x + stepY * y + offset;
+    }
+};
+
+// Narrows [first, last] down to the steps ii for which value + ii * step is
+// non-negative, in the way EdgeCrossing::clip does
+void clipSteps(long long value, long long step, long long& first, long long& last) {
+    if (step > 0) {
+        first = std::max(first, -floorDivide(value, step));
+    } else if (step < 0) {
+        last = std::min(last, floorDivide(value, -step));
+    } else if (value < 0) {
+        last = -1;
+    }
+}
+
+// Fills a triangle into a multisampled buffer with a depth test, from
+// vertices in subpixel units: a vertex at pixel (x, y) is given as
+// (x * RASTERIZER_SUBPIXEL_SCALE, y * RASTERIZER_SUBPIXEL_SCALE), and can
+// lie anywhere in between. As elsewhere, pixel centers are at whole pixel
+// coordinates.
+//
+// Every sample is tested against the edge functions, giving each pixel a
+// mask of the samples the triangle covers. Those still to be tested are
+// found a row at a time, the way FILL_EDGE finds its runs, as two nested
+// runs: pixels that have any sample inside all three edges, and within
+// them, pixels that have every sample inside. Only the pixels in between,
+// along the triangle's edges, test their samples one at a time. The
+// covered samples are then depth tested each at its own depth, and the
+// color, which is the same for every sample, is stored once per pixel
+// into those that pass.
+//
+// Returns how many pixels had any sample written.
+unsigned int fillTriangleMultisample(Vec2 v0, Vec2 v1, Vec2 v2, float z0, float z1, float z2,
+                                     MultisampleBuffer& target, ColorRGB color) {
+    const int scale = RASTERIZER_SUBPIXEL_SCALE;
+    const Vec2* vertices[3] = {&v0, &v1, &v2};
+    for (const Vec2* vertex : vertices) {
+        if (std::abs(vertex->x) > RASTERIZER_MAX_COORDINATE * scale ||
+            std::abs(vertex->y) > RASTERIZER_MAX_COORDINATE * scale) {
+            return 0;
+        }
+    }
+
+    long long area = (long long)(v1.x - v0.x) * (v2.y - v0.y) - (long long)(v1.y - v0.y) * (v2.x - v0.x);
+    if (area == 0) {
+        return 0;
+    }
+    if (area < 0) {
+        std::swap(v1, v2);
+        std::swap(z1, z2);
+        area = -area;
+    }
+
+    // Every sample lies within half a pixel of its pixel's center, so this
+    // takes in every pixel that may have one inside
+    const Vec2 lower = v0.min(v1.min(v2));
+    const Vec2 upper = v0.max(v1.max(v2));
+    const int minX = std::max(0, floorDivide(lower.x, scale));
+    const int minY = std::max(0, floorDivide(lower.y, scale));
+    const int maxX = std::min<int>(target.getWidth() - 1, floorDivide(upper.x, scale) + 1);
+    const int maxY = std::min<int>(target.getHeight() - 1, floorDivide(upper.y, scale) + 1);
+    if (minX > maxX || minY > maxY) {
+        return 0;
+    }
+
+    const SubpixelEdgeFunction edges[3] = {SubpixelEdgeFunction(v1, v2), SubpixelEdgeFunction(v2, v0),
+                                           SubpixelEdgeFunction(v0, v1)};
+
+    // How much each sample's position adds to each edge function, over its
+    // pixel's center, and the least and most over all samples
+    const unsigned int samples = target.getSamples();
+    long long sampleOffsets[3][MULTISAMPLE_MAX_SAMPLES];
+    long long leastOffset[3];
+    long long mostOffset[3];
+    for (int ee = 0; ee < 3; ++ee) {
+        for (unsigned int ss = 0; ss < samples; ++ss) {
+            sampleOffsets[ee][ss] = edges[ee].stepX * target.getSampleX(ss) + edges[ee].stepY * target.getSampleY(ss);
+        }
+        leastOffset[ee] = *std::min_element(sampleOffsets[ee], sampleOffsets[ee] + samples);
+        mostOffset[ee] = *std::max_element(sampleOffsets[ee], sampleOffsets[ee] + samples);
+    }
+
+    // The depth plane, per subpixel unit, as in fillTriangleDepth, and how
+    // much each sample's position adds to its pixel's depth
+    const double dzdx = (edges[0].stepX * (double)z0 + edges[1].stepX * (double)z1 + edges[2].stepX * (double)z2) / area;
+    const double dzdy = (edges[0].stepY * (double)z0 + edges[1].stepY * (double)z1 + edges[2].stepY * (double)z2) / area;
+    float sampleDepths[MULTISAMPLE_MAX_SAMPLES];
+    for (unsigned int ss = 0; ss < samples; ++ss) {
+        sampleDepths[ss] = (float)(dzdx * target.getSampleX(ss) + dzdy * target.getSampleY(ss));
+    }
+    const float pixelDzdx = (float)(dzdx * scale);
+
+    const unsigned int fullMask = target.getFullMask();
+    const unsigned int width = target.getWidth();
+    float* depths = target.getDepthData();
+    unsigned int written = 0;
+
+    for (int yy = minY; yy <= maxY; ++yy) {
+        // Each edge function at the center of the row's first pixel, and how
+        // much it changes from one pixel to the next
+        long long values[3];
+        long long steps[3];
+        for (int ee = 0; ee < 3; ++ee) {
+            values[ee] = edges[ee].at((long long)minX * scale, (long long)yy * scale);
+            steps[ee] = edges[ee].stepX * scale;
+        }
+
+        // Pixels with any sample inside every edge, and with every sample inside
+        long long first = 0;
+        long long last = maxX - minX;
+        for (int ee = 0; ee < 3; ++ee) {
+            clipSteps(values[ee] + mostOffset[ee], steps[ee], first, last);
+        }
+        if (first > last) {
+            continue;
+        }
+        long long innerFirst = first;
+        long long innerLast = last;
+        for (int ee = 0; ee < 3; ++ee) {
+            clipSteps(values[ee] + leastOffset[ee], steps[ee], innerFirst, innerLast);
+        }
+
+        float zz = (float)(z0 + dzdx * ((long long)(minX + first) * scale - v0.x) +
+                           dzdy * ((long long)yy * scale - v0.y));
+        unsigned int pixel = yy * width + minX + first;
+        for (long long ii = first; ii <= last; ++ii, ++pixel, zz += pixelDzdx) {
+            unsigned int covered = fullMask;
+            if (ii < innerFirst || ii > innerLast) {
+                covered = 0;
+                for (unsigned int ss = 0; ss < samples; ++ss) {
+                    bool inside = true;
+                    for (int ee = 0; ee < 3; ++ee) {
+                        inside &= values[ee] + ii * steps[ee] + sampleOffsets[ee][ss] >= 0;
+                    }
+                    covered |= (unsigned int)inside << ss;
+                }
+            }
+
+            unsigned int passed = 0;
+            float* sampleDepth = depths + pixel * samples;
+            for (unsigned int ss = 0; ss < samples; ++ss) {
+                const float depth = zz + sampleDepths[ss];
+                if ((covered & (1u << ss)) && depth < sampleDepth[ss]) {
+                    sampleDepth[ss] = depth;
+                    passed |= 1u << ss;
+                }
+            }
+
+            if (passed) {
+                target.writeSamples(pixel, passed, color);
+                ++written;
+            }
+        }
+    }
+
+    return written;
+}
+
+// A vertex ready for fillTriangleTextured
+struct TexturedVertex {
+    Vec2 position;     // On the screen, in pixels
+    float depth;       // For the depth buffer, from 0 to 1
+    float inverseW;    // 1 / w, from the projection
+    float u, v;        // Texture coordinates
+    Vec3 normal;       // For lighting
+};
+
+// Fills a triangle with a texture, lit from lightDirection by the normals of
+// its vertices, with a depth test, running along the same runs of pixels
+// as FILL_EDGE.
+//
+// Depth changes linearly across the screen, but the texture coordinates
+// and normals do not once a triangle is seen in perspective. Each
+// attribute divided by w does, though, as does 1 / w itself, so those are
+// what get interpolated, a plane each. Every pixel then divides by its
+// own 1 / w to get the attributes back. The same planes give how quickly
+// the texture coordinates change from one pixel to the next, for the
+// texture to choose a mip level with.
+//
+// Only pixels within the rectangle from clipMin to clipMax (inclusive),
+// which must lie within the image, are written. Returns how many were.
+// Unlike fillTriangleDepth this does not keep the depth buffer's tiles up
+// to date, which is safe, as their farthest depths are only ever left
+// farther than they need be.
+unsigned int fillTriangleTextured(TexturedVertex a, TexturedVertex b, TexturedVertex c, TGA& image,
+                                  DepthBuffer& depth, const Texture& texture, const Vec3& lightDirection,
+                                  Vec2 clipMin, Vec2 clipMax) {
+    int area = (b.position.x - a.position.x) * (c.position.y - a.position.y) -
+               (b.position.y - a.position.y) * (c.position.x - a.position.x);
+    if (area < 0) {
+        std::swap(b, c);
+        area = -area;
+    }
+
+    Vec2 boxMin, boxMax;
+    if (!setUpTriangle(a.position, b.position, c.position, clipMin, clipMax, boxMin, boxMax)) {
+        return 0;
+    }
+
+    EdgeFunction e0(b.position, c.position);
+    EdgeFunction e1(c.position, a.position);
+    EdgeFunction e2(a.position, b.position);
+
+    // The attributes interpolated: depth, then 1 / w, then u, v and the
+    // normal, each over w
+    const int ATTRIBUTES = 7;
+    const TexturedVertex* vertices[3] = {&a, &b, &c};
+    float values[3][ATTRIBUTES];
+    for (int vv = 0; vv < 3; ++vv) {
+        const TexturedVertex& vertex = *vertices[vv];
+        const float q = vertex.inverseW;
+        const float attributes[ATTRIBUTES] = {vertex.depth, q, vertex.u * q, vertex.v * q,
+                                              vertex.normal.x * q, vertex.normal.y * q, vertex.normal.z * q};
+        std::copy(attributes, attributes + ATTRIBUTES, values[vv]);
+    }
+
+    // A plane for each attribute: the value at the top left of the bounding
+    // box, and how much it changes a pixel across and a pixel down
+    float start[ATTRIBUTES];
+    float stepX[ATTRIBUTES];
+    float stepY[ATTRIBUTES];
+    for (int ii = 0; ii < ATTRIBUTES; ++ii) {
+        stepX[ii] = (e0.stepX * values[0][ii] + e1.stepX * values[1][ii] + e2.stepX * values[2][ii]) / area;
+        stepY[ii] = (e0.stepY * values[0][ii] + e1.stepY * values[1][ii] + e2.stepY * values[2][ii]) / area;
+        start[ii] = values[0][ii] + stepX[ii] * (boxMin.x - a.position.x) + stepY[ii] * (boxMin.y - a.position.y);
+    }
+
+    EdgeCrossing c0(e0, e0.at(boxMin.x, boxMin.y));
+    EdgeCrossing c1(e1, e1.at(boxMin.x, boxMin.y));
+    EdgeCrossing c2(e2, e2.at(boxMin.x, boxMin.y));
+
+    const Vec3 light = lightDirection.normalized();
+    const int width = image.getWidth();
+    unsigned int written = 0;
+
+    for (int yy = boxMin.y; yy <= boxMax.y; ++yy) {
+        int first = 0;
+        int last = boxMax.x - boxMin.x;
+        c0.clip(first, last);
+        c1.clip(first, last);
+        c2.clip(first, last);
+        c0.nextRow(e0.stepY);
+        c1.nextRow(e1.stepY);
+        c2.nextRow(e2.stepY);
+        if (first > last) {
+            continue;
+        }
+
+        float attributes[ATTRIBUTES];
+        for (int ii = 0; ii < ATTRIBUTES; ++ii) {
+            attributes[ii] = start[ii] + stepX[ii] * first + stepY[ii] * (yy - boxMin.y);
+        }
+        float* depthRow = depth.getDepthData() + yy * width + boxMin.x;
+        unsigned char* pixelRow = image.getPixelData() + (yy * width + boxMin.x) * 3;
+
+        for (int xx = first; xx <= last; ++xx) {
+            if (attributes[0] < depthRow[xx]) {
+                depthRow[xx] = attributes[0];
+
+                const float w = 1.0f / attributes[1];
+                const float u = attributes[2] * w;
+                const float v = attributes[3] * w;
+
+                // The quotient rule, for how u = (u / w) / (1 / w) changes
+                const float dudx = (stepX[2] - u * stepX[1]) * w;
+                const float dvdx = (stepX[3] - v * stepX[1]) * w;
+                const float dudy = (stepY[2] - u * stepY[1]) * w;
+                const float dvdy = (stepY[3] - v * stepY[1]) * w;
+                ColorRGB texel = texture.sample(u, v, dudx, dvdx, dudy, dvdy);
+
+                // The normal only needs normalizing, which takes care of w too
+                Vec3 normal(attributes[4], attributes[5], attributes[6]);
+                const float length = std::sqrt(normal.dot(normal));
+                const float facing = length > 0.0f ? std::max(0.0f, normal.dot(light) / length) : 1.0f;
+                const float intensity = 0.15f + 0.85f * facing;
+
+                pixelRow[xx * 3] = (unsigned char)(texel.r * intensity);
+                pixelRow[xx * 3 + 1] = (unsigned char)(texel.g * intensity);
+                pixelRow[xx * 3 + 2] = (unsigned char)(texel.b * intensity);
+                ++written;
+            }
+
+            for (int ii = 0; ii < ATTRIBUTES; ++ii) {
+                attributes[ii] += stepX[ii];
+            }
+        }
+    }
+
+    return written;
+}
+
+// Fills a textured triangle as above, anywhere within the image
+unsigned int fillTriangleTextured(const TexturedVertex& a, const TexturedVertex& b, const TexturedVertex& c,
+                                  TGA& image, DepthBuffer& depth, const Texture& texture,
+                                  const Vec3& lightDirection) {
+    return fillTriangleTextured(a, b, c, image, depth, texture, lightDirection, Vec2(0, 0),
+                                Vec2(image.getWidth() - 1, image.getHeight() - 1));
+}
+
+// Draws a triangle with the given fill mode (see GL.h), writing only
+// pixels within the rectangle from clipMin to clipMax (inclusive), which
+// must lie within the image
+void triangle(Vec2 v0, Vec2 v1, Vec2 v2, TGA& image, ColorRGB color, int mode, Vec2 clipMin, Vec2 clipMax) {
+    if (mode == LINE) {
+        drawLine(v0, v1, image, color, clipMin, clipMax);
+        drawLine(v1, v2, image, color, clipMin, clipMax);
+        drawLine(v2, v0, image, color, clipMin, clipMax);
+    } else if (mode == FILL) {
+        // Create vectors to represent a bounding box for the requested
+        // triangle, within the clip rectangle
+        Vec2 tl = v0.min(v1.min(v2)).max(clipMin);
+        Vec2 br = v0.max(v1.max(v2)).min(clipMax + Vec2(1, 1));
+
+        // Color all pixels in the bounding box that lie inside the triangle
+        for (int ii = tl.x; ii < br.x; ++ii) {
+            for (int jj = tl.y; jj < br.y; ++jj) {
+                Vec2 pos = Vec2(ii, jj);
+                if (insideOfTriangle(pos, v0, v1, v2)) {
+                    image.setPixelColor(ii, jj, color);
+                }
+            }
+        }
+    } else if (mode == FILL_EDGE) {
+        fillTriangleEdge(v0, v1, v2, image, color, clipMin, clipMax);
+    } else if (mode == FILL_BLOCK) {
+        fillTriangleBlock(v0, v1, v2, image, color, clipMin, clipMax);
+    }
+}
+
+// Draw a triangle, with the fill mode glPolygonMode last set on this thread
+void triangle(Vec2 v0, Vec2 v1, Vec2 v2, TGA& image, ColorRGB color) {
+    triangle(v0, v1, v2, image, color, glFillMode, Vec2(0, 0), Vec2(image.getWidth() - 1, image.getHeight() - 1));
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef RENDER_CONTEXT_H
+#define RENDER_CONTEXT_H
+
+/** @file RenderContext.h
+ *  @brief Keeps the state of the drawing pipeline together with what it draws on
+ *
+ *  Note this is implemented as a header only library.
+ *  This is to make this code easy to be shared.
+ *
+ *  A RenderContext holds everything that decides how a shape is drawn: the
+ *  image and depth buffer it is drawn on, the fill mode, the viewport and
+ *  whether the depth test is on. Nothing is shared between contexts, so
+ *  any number of them can draw at the same time, each on its own thread,
+ *  as long as no two of them write the same pixels. That can mean each
+ *  context drawing on an image of its own, or all of them drawing on one
+ *  large image, each within a viewport of its own.
+ *
+ *  A context is meant to be used from one thread at a time.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// User libraries
+#include "GL.h"
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "DepthBuffer.h"
+#include "Rasterizer.h"
+
+class RenderContext {
+public:
+
+    // Constructor
+    // Draws on the given image, and tests against the given depth buffer if
+    // there is one, which must then be the same size as the image. The
+    // viewport starts out as the whole image, the fill mode as LINE and the
+    // depth test as off.
+    RenderContext(TGA& target, DepthBuffer* depth = nullptr) : m_target(&target), m_depth(depth) {
+        setViewport(0, 0, target.getWidth(), target.getHeight());
+    }
+
+    // The image drawn on
+    TGA& getTarget() const {
+        return *m_target;
+    }
+
+    // The depth buffer tested against, if any
+    DepthBuffer* getDepthBuffer() const {
+        return m_depth;
+    }
+
+    // Sets how triangles are filled (see GL.h), as glPolygonMode does
+    void setPolygonMode(int mode) {
+        m_fillMode = mode;
+    }
+
+    int getPolygonMode() const {
+        return m_fillMode;
+    }
+
+    // Sets the rectangle of the image that gets drawn on, as glViewport
+    // does. Positions are then given in pixels from its top left corner, and
+    // nothing outside of it is drawn. The rectangle is cut down to fit
+    // within the image.
+    //
+    // Contexts sharing a depth buffer should keep their viewports lined up
+    // with its tiles (on multiples of DEPTH_TILE_SIZE), as drawing in one
+    // part of a tile looks at the depth of all of it.
+    void setViewport(int x, int y, int width, int height) {
+        m_viewportMin = Vec2(x, y).max(Vec2(0, 0));
+        m_viewportMax = Vec2(x + width - 1, y + height - 1).min(Vec2(m_target->getWidth() - 1, m_target->getHeight() - 1));
+        m_origin = Vec2(x, y);
+    }
+
+    // Top left corner of the viewport, within the image
+    Vec2 getViewportMin() const {
+        return m_viewportMin;
+    }
+
+    // Bottom right corner of the viewport, within the image (inclusive)
+    Vec2 getViewportMax() const {
+        return m_viewportMax;
+    }
+
+    // Turns testing against the depth buffer on or off. It stays off while
+    // there is no depth buffer.
+    void setDepthTest(bool enabled) {
+        m_depthTest = enabled;
+    }
+
+    bool getDepthTest() const {
+        return m_depthTest && m_depth != nullptr;
+    }
+
+    // Draws a line
+    void drawLine(Vec2 v0, Vec2 v1, ColorRGB color) {
+        if (hasViewport()) {
+            ::drawLine(v0 + m_origin, v1 + m_origin, *m_target, color, m_viewportMin, m_viewportMax);
+        }
+    }
+
+    // Draws a triangle with the context's fill mode
+    void drawTriangle(Vec2 v0, Vec2 v1, Vec2 v2, ColorRGB color) {
+        if (hasViewport()) {
+            triangle(v0 + m_origin, v1 + m_origin, v2 + m_origin, *m_target, color, m_fillMode, m_viewportMin,
+                     m_viewportMax);
+        }
+    }
+
+    // Draws a triangle with the given depth at each vertex. With the depth
+    // test on, it is filled with a depth test whatever the fill mode, as
+    // fillTriangleDepth does; otherwise the depths are not used.
+    void drawTriangle(Vec2 v0, Vec2 v1, Vec2 v2, float z0, float z1, float z2, ColorRGB color) {
+        if (!getDepthTest()) {
+            drawTriangle(v0, v1, v2, color);
+        } else if (hasViewport()) {
+            fillTriangleDepth(v0 + m_origin, v1 + m_origin, v2 + m_origin, z0, z1, z2, *m_target, *m_depth, color,
+                              m_viewportMin, m_viewportMax);
+        }
+    }
+
+private:
+    // Whether any of the viewport lies within the image
+    bool hasViewport() const {
+        return m_viewportMin.x <= m_viewportMax.x && m_viewportMin.y <= m_viewportMax.y;
+    }
+
+    TGA* m_target;
+    DepthBuffer* m_depth;
+    int m_fillMode{LINE};
+    bool m_depthTest{false};
+    Vec2 m_origin;
+    Vec2 m_viewportMin;
+    Vec2 m_viewportMax;
+};
+
+#endif
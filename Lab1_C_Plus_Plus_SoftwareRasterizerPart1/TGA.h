@@ -21,14 +21,14 @@
  */
 
 // Standard Libraries
+#include <cstdio>
+#include <cstring>
 #include <string>
-#include <fstream>
+#include <vector>
 
 // User Libraries
 #include "Color.h"
 
-#include <cstring>
-
 class TGA {
 public:
     
@@ -68,23 +68,132 @@ public:
         m_pixelData[((y * width + x) * 3) + 2] = c.b;
     }
 
-    // Helper function to write out a .tga image file
-    void outputTGAImage(std::string fileName) {
-       std::ofstream myFile(fileName.c_str());
-       if (myFile.is_open()) {
-            FILE *fp; fp = fopen(fileName.c_str(), "w+");
-            fputs("P3\n", fp);
-            fputs("320 320\n", fp);
-            fputs("255\n", fp);
-            for (unsigned int ii = 0; ii < width * height * 3; ii++) {
-                    fprintf(fp, "%d", m_pixelData[ii]); fputs(" ", fp); fputs("\n", fp);
+    // Width of the image in pixels
+    unsigned int getWidth() const {
+        return width;
+    }
+
+    // Height of the image in pixels
+    unsigned int getHeight() const {
+        return height;
+    }
+
+    // The R,G,B values of every pixel, row after row, for
+    // drawing code that walks along rows itself.
+    unsigned char* getPixelData() {
+        return m_pixelData;
+    }
+
+    // Writes the image out as a .tga file, run-length encoded unless
+    // compressed is false. Returns false if the file cannot be written.
+    //
+    // The header marks the first row as the top one, so rows go out in the
+    // order they are kept, each turned from R,G,B to the B,G,R order TGA
+    // files keep their pixels in, and written whole through a buffer.
+    bool outputTGAImage(const std::string& fileName, bool compressed = true) {
+        // TGA keeps the width and height in 16 bits
+        if (width > 0xFFFF || height > 0xFFFF) {
+            return false;
+        }
+        FILE* file = fopen(fileName.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        setvbuf(file, nullptr, _IOFBF, 1 << 16);
+
+        unsigned char header[18] = {0};
+        header[2] = compressed ? 10 : 2;    // Run-length encoded or uncompressed true color
+        header[12] = width & 0xFF;
+        header[13] = width >> 8;
+        header[14] = height & 0xFF;
+        header[15] = height >> 8;
+        header[16] = 24;                    // Bits per pixel
+        header[17] = 0x20;                  // The first row is the top one
+        bool written = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+        // A row can grow by at most a byte for every pixel when encoded
+        std::vector<unsigned char> row(width * 4);
+        for (unsigned int yy = 0; yy < height && written; ++yy) {
+            const unsigned char* pixels = m_pixelData + yy * width * 3;
+            size_t length = width * 3;
+            if (compressed) {
+                length = encodeRow(pixels, row.data());
+            } else {
+                swapPixels(pixels, row.data(), width);
             }
-            fclose(fp);
-            myFile.close();
-       }  
+            written = fwrite(row.data(), 1, length, file) == length;
+        }
+
+        // The footer of version 2 of the format, with no extension area
+        const char footer[26] = "\0\0\0\0\0\0\0\0TRUEVISION-XFILE.";
+        written = written && fwrite(footer, 1, sizeof(footer), file) == sizeof(footer);
+        return fclose(file) == 0 && written;
+    }
+
+    // Writes the image out as a binary .ppm (P6) file, which most image
+    // viewers open. Returns false if the file cannot be written.
+    bool outputPPMImage(const std::string& fileName) {
+        FILE* file = fopen(fileName.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        setvbuf(file, nullptr, _IOFBF, 1 << 16);
+
+        bool written = fprintf(file, "P6\n%u %u\n255\n", width, height) > 0;
+        for (unsigned int yy = 0; yy < height && written; ++yy) {
+            written = fwrite(m_pixelData + yy * width * 3, 3, width, file) == width;
+        }
+        return fclose(file) == 0 && written;
     }
 
 private:
+    // Run-length encodes a row of pixels into out, returning the number of
+    // bytes written. Each packet starts with a byte holding one less than
+    // the number of pixels it covers, up to 128. With the top bit set, a
+    // single pixel follows that is repeated that many times; otherwise that
+    // many pixels follow as they are. Packets never run from one row into
+    // the next.
+    size_t encodeRow(const unsigned char* pixels, unsigned char* out) const {
+        unsigned char* start = out;
+        unsigned int xx = 0;
+        while (xx < width) {
+            // Count how many times this pixel repeats
+            unsigned int run = 1;
+            while (xx + run < width && run < 128 && memcmp(pixels + xx * 3, pixels + (xx + run) * 3, 3) == 0) {
+                ++run;
+            }
+            if (run > 1) {
+                *out++ = 0x80 | (run - 1);
+                swapPixels(pixels + xx * 3, out, 1);
+                out += 3;
+                xx += run;
+                continue;
+            }
+
+            // Otherwise gather pixels up until the next one that repeats
+            unsigned int count = 1;
+            while (xx + count < width && count < 128 &&
+                   (xx + count + 1 >= width ||
+                    memcmp(pixels + (xx + count) * 3, pixels + (xx + count + 1) * 3, 3) != 0)) {
+                ++count;
+            }
+            *out++ = count - 1;
+            swapPixels(pixels + xx * 3, out, count);
+            out += count * 3;
+            xx += count;
+        }
+        return out - start;
+    }
+
+    // Copies count pixels to out with red and blue swapped
+    static void swapPixels(const unsigned char* pixels, unsigned char* out, unsigned int count) {
+        for (unsigned int xx = 0; xx < count; ++xx) {
+            out[xx * 3] = pixels[xx * 3 + 2];
+            out[xx * 3 + 1] = pixels[xx * 3 + 1];
+            out[xx * 3 + 2] = pixels[xx * 3];
+        }
+    }
+
     unsigned char* m_pixelData;
     unsigned int width{0};
     unsigned int height{0};
@@ -0,0 +1,290 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+/** @file Texture.h
+ *  @brief A texture loaded from a .ppm image, for the rasterizer to sample
+ *
+ *  Note this is implemented as a header only library.
+ *  This is to make this code easy to be shared.
+ *
+ *  The texels are not kept a row at a time the way the image stores them.
+ *  They are grouped into tiles of 4x4 texels, each 64 bytes, one cache
+ *  line, and the tiles are stored a row of tiles at a time. Texels next to
+ *  each other in either direction are then mostly in the same cache line,
+ *  which suits the rasterizer, as a triangle is seldom lined up with the
+ *  texture's rows: bilinear filtering reads a 2x2 block of texels, and
+ *  neighbouring pixels of a triangle read neighbouring blocks.
+ *
+ *  Below the image itself is a chain of mip levels, each half the size of
+ *  the one above, down to a single texel. With mipmapping on, a triangle
+ *  far away reads from the level whose texels are closest to its pixels in
+ *  size, rather than skipping over most of the texels of the full image.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// User libraries
+#include "Color.h"
+
+// Width and height in texels of the tiles a texture is stored in
+#define TEXTURE_TILE_BITS 2
+#define TEXTURE_TILE_SIZE (1 << TEXTURE_TILE_BITS)
+
+// How a texture is filtered
+const int TEXTURE_NEAREST = 0;
+const int TEXTURE_BILINEAR = 1;
+
+class Texture {
+public:
+
+    // Constructor
+    // The texture is empty until an image is loaded into it.
+    Texture() { }
+
+    // Loads a .ppm image, either P3 (text) or P6 (binary), and builds its
+    // mip levels. Returns false if the file cannot be opened or is not a
+    // .ppm image.
+    bool load(const std::string& fileName) {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        char magic[3] = {0};
+        int width = 0, height = 0, maxValue = 0;
+        bool valid = fscanf(file, "%2s", magic) == 1 && (magic[1] == '3' || magic[1] == '6') && magic[0] == 'P' &&
+                     readNumber(file, width) && readNumber(file, height) && readNumber(file, maxValue) &&
+                     width > 0 && height > 0 && maxValue > 0 && maxValue < 256;
+
+        std::vector<unsigned char> pixels;
+        if (valid) {
+            pixels.resize(width * height * 3);
+            if (magic[1] == '6') {
+                // A single whitespace character separates the header from the data
+                fgetc(file);
+                valid = fread(pixels.data(), 1, pixels.size(), file) == pixels.size();
+            } else {
+                for (unsigned char& value : pixels) {
+                    int number = 0;
+                    if (!readNumber(file, number)) {
+                        valid = false;
+                        break;
+                    }
+                    value = (unsigned char)std::min(number, 255);
+                }
+            }
+        }
+        fclose(file);
+        if (!valid) {
+            return false;
+        }
+
+        if (maxValue != 255) {
+            for (unsigned char& value : pixels) {
+                value = (unsigned char)(value * 255 / maxValue);
+            }
+        }
+        setPixels(pixels.data(), width, height);
+        return true;
+    }
+
+    // Fills the texture from R,G,B pixels a row at a time, the way TGA
+    // keeps them, and builds its mip levels
+    void setPixels(const unsigned char* pixels, int width, int height) {
+        m_levels.clear();
+        m_levels.push_back(Level(width, height));
+        Level& top = m_levels.back();
+        for (int yy = 0; yy < height; ++yy) {
+            for (int xx = 0; xx < width; ++xx) {
+                const unsigned char* pixel = pixels + (yy * width + xx) * 3;
+                ColorRGBA& texel = top.texel(xx, yy);
+                texel.r = pixel[0];
+                texel.g = pixel[1];
+                texel.b = pixel[2];
+                texel.a = 255;
+            }
+        }
+
+        // Each texel of the next level down averages 2x2 texels of this one
+        while (m_levels.back().width > 1 || m_levels.back().height > 1) {
+            const Level& above = m_levels.back();
+            Level below(std::max(1, above.width / 2), std::max(1, above.height / 2));
+            for (int yy = 0; yy < below.height; ++yy) {
+                for (int xx = 0; xx < below.width; ++xx) {
+                    const int x0 = std::min(xx * 2, above.width - 1), x1 = std::min(xx * 2 + 1, above.width - 1);
+                    const int y0 = std::min(yy * 2, above.height - 1), y1 = std::min(yy * 2 + 1, above.height - 1);
+                    const ColorRGBA& a = above.texel(x0, y0);
+                    const ColorRGBA& b = above.texel(x1, y0);
+                    const ColorRGBA& c = above.texel(x0, y1);
+                    const ColorRGBA& d = above.texel(x1, y1);
+                    ColorRGBA& texel = below.texel(xx, yy);
+                    texel.r = (unsigned char)((a.r + b.r + c.r + d.r + 2) / 4);
+                    texel.g = (unsigned char)((a.g + b.g + c.g + d.g + 2) / 4);
+                    texel.b = (unsigned char)((a.b + b.b + c.b + d.b + 2) / 4);
+                    texel.a = (unsigned char)((a.a + b.a + c.a + d.a + 2) / 4);
+                }
+            }
+            m_levels.push_back(below);
+        }
+    }
+
+    // Width of the full size image in texels
+    int getWidth() const {
+        return m_levels.empty() ? 0 : m_levels[0].width;
+    }
+
+    // Height of the full size image in texels
+    int getHeight() const {
+        return m_levels.empty() ? 0 : m_levels[0].height;
+    }
+
+    // Number of mip levels, the full size image included
+    int getLevels() const {
+        return m_levels.size();
+    }
+
+    // Chooses between TEXTURE_NEAREST and TEXTURE_BILINEAR filtering
+    void setFilter(int filter) {
+        m_filter = filter;
+    }
+
+    // Turns mipmapping on or off
+    void setMipmaps(bool mipmaps) {
+        m_mipmaps = mipmaps;
+    }
+
+    // Color at the given texture coordinates, which wrap around outside of
+    // 0 to 1. (0, 0) is the bottom left corner of the image, as in OpenGL.
+    //
+    // The derivatives are how far the coordinates move from one pixel to the
+    // next across and down the screen, as for GLSL's textureGrad. With
+    // mipmapping on they choose the level to read from; otherwise they are
+    // not used.
+    ColorRGB sample(float u, float v, float dudx, float dvdx, float dudy, float dvdy) const {
+        int level = 0;
+        if (m_mipmaps) {
+            // The level whose texels are nearest in size to the larger side
+            // of the pixel's footprint on the texture. As each level halves
+            // the size, that is the log2 of the side's length in texels of
+            // the full size image, or half the log2 of its square.
+            const float width = getWidth(), height = getHeight();
+            const float acrossX = dudx * width, acrossY = dvdx * height;
+            const float downX = dudy * width, downY = dvdy * height;
+            const float footprint = std::max(acrossX * acrossX + acrossY * acrossY, downX * downX + downY * downY);
+            if (footprint >= 1.0f) {
+                level = std::min(std::ilogb(footprint) / 2, getLevels() - 1);
+            }
+        }
+
+        return m_filter == TEXTURE_BILINEAR ? sampleBilinear(m_levels[level], u, v) : sampleNearest(m_levels[level], u, v);
+    }
+
+private:
+    // One mip level, stored in tiles
+    struct Level {
+        int width;
+        int height;
+        int tilesX;
+        std::vector<ColorRGBA> texels;
+
+        Level(int _width, int _height) : width(_width), height(_height) {
+            tilesX = (width + TEXTURE_TILE_SIZE - 1) >> TEXTURE_TILE_BITS;
+            const int tilesY = (height + TEXTURE_TILE_SIZE - 1) >> TEXTURE_TILE_BITS;
+            texels.resize(tilesX * tilesY * TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE);
+        }
+
+        // Finds a texel's tile, and then its place within the tile
+        int index(int x, int y) const {
+            const int tile = (y >> TEXTURE_TILE_BITS) * tilesX + (x >> TEXTURE_TILE_BITS);
+            const int mask = TEXTURE_TILE_SIZE - 1;
+            return (tile << (2 * TEXTURE_TILE_BITS)) + ((y & mask) << TEXTURE_TILE_BITS) + (x & mask);
+        }
+
+        ColorRGBA& texel(int x, int y) {
+            return texels[index(x, y)];
+        }
+
+        const ColorRGBA& texel(int x, int y) const {
+            return texels[index(x, y)];
+        }
+    };
+
+    // Reads the next number of a .ppm file, skipping any comments before it
+    static bool readNumber(FILE* file, int& number) {
+        int character = fgetc(file);
+        while (character != EOF) {
+            if (character == '#') {
+                while (character != EOF && character != '\n') {
+                    character = fgetc(file);
+                }
+            } else if (character != ' ' && character != '\t' && character != '\r' && character != '\n') {
+                break;
+            }
+            character = fgetc(file);
+        }
+        if (character == EOF) {
+            return false;
+        }
+        ungetc(character, file);
+        return fscanf(file, "%d", &number) == 1;
+    }
+
+    // Wraps a texel coordinate around into 0 to size - 1
+    static int wrap(int coordinate, int size) {
+        coordinate %= size;
+        return coordinate < 0 ? coordinate + size : coordinate;
+    }
+
+    // The texel the coordinates fall in
+    static ColorRGB sampleNearest(const Level& level, float u, float v) {
+        const int xx = wrap((int)std::floor(u * level.width), level.width);
+        const int yy = wrap((int)std::floor((1.0f - v) * level.height), level.height);
+        const ColorRGBA& texel = level.texel(xx, yy);
+        ColorRGB color;
+        color.r = texel.r; color.g = texel.g; color.b = texel.b;
+        return color;
+    }
+
+    // A blend of the four texels whose centers surround the coordinates,
+    // weighted in 8 bit fixed point
+    static ColorRGB sampleBilinear(const Level& level, float u, float v) {
+        const float x = u * level.width - 0.5f;
+        const float y = (1.0f - v) * level.height - 0.5f;
+        const float floorX = std::floor(x), floorY = std::floor(y);
+        const int weightX = (int)((x - floorX) * 256.0f);
+        const int weightY = (int)((y - floorY) * 256.0f);
+
+        const int x0 = wrap((int)floorX, level.width), x1 = wrap(x0 + 1, level.width);
+        const int y0 = wrap((int)floorY, level.height), y1 = wrap(y0 + 1, level.height);
+        const ColorRGBA& a = level.texel(x0, y0);
+        const ColorRGBA& b = level.texel(x1, y0);
+        const ColorRGBA& c = level.texel(x0, y1);
+        const ColorRGBA& d = level.texel(x1, y1);
+
+        ColorRGB color;
+        color.r = blend(a.r, b.r, c.r, d.r, weightX, weightY);
+        color.g = blend(a.g, b.g, c.g, d.g, weightX, weightY);
+        color.b = blend(a.b, b.b, c.b, d.b, weightX, weightY);
+        return color;
+    }
+
+    static unsigned char blend(int a, int b, int c, int d, int weightX, int weightY) {
+        const int top = a * 256 + (b - a) * weightX;
+        const int bottom = c * 256 + (d - c) * weightX;
+        return (unsigned char)((top * 256 + (bottom - top) * weightY + (1 << 15)) >> 16);
+    }
+
+    std::vector<Level> m_levels;
+    int m_filter{TEXTURE_BILINEAR};
+    bool m_mipmaps{true};
+};
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+/** @file TileRenderer.h
+ *  @brief Draws triangles onto a TGA image on several threads at once
+ *
+ *  Note this is implemented as a header only library.
+ *  This is to make this code easy to be shared.
+ *
+ *  Triangles are not drawn as they are submitted, but recorded in a
+ *  command list. When the list is flushed, every triangle is binned into
+ *  each 64x64 tile of the image its bounding box touches, and a pool of
+ *  worker threads then takes tiles one at a time and draws the triangles
+ *  binned into each, clipped to the tile. No two threads ever write the
+ *  same tile, so no locks are needed around the image, and each tile
+ *  draws its triangles in the order they were submitted, so the result is
+ *  the same as drawing them one after another with FILL_EDGE. When built
+ *  with -mavx2, triangles smaller than a tile are drawn with FILL_BLOCK,
+ *  which covers exactly the same pixels.
+ *
+ *  Compile anything using this with -pthread.
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// User libraries
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "Rasterizer.h"
+
+// Width and height of a tile in pixels
+#define TILE_SIZE 64
+
+class TileRenderer {
+public:
+
+    // Constructor
+    // Starts the given number of threads, or one per hardware thread if
+    // zero. The thread calling flush works too, so one fewer is started.
+    TileRenderer(TGA& image, unsigned int numThreads = 0) : m_image(image) {
+        if (numThreads == 0) {
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        m_tilesX = (image.getWidth() + TILE_SIZE - 1) / TILE_SIZE;
+        m_tilesY = (image.getHeight() + TILE_SIZE - 1) / TILE_SIZE;
+        m_bins.resize(m_tilesX * m_tilesY);
+
+        for (unsigned int ii = 1; ii < numThreads; ++ii) {
+            m_workers.push_back(std::thread(&TileRenderer::workerLoop, this));
+        }
+    }
+
+    // Destructor
+    // Stops and joins every worker.
+    ~TileRenderer() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    // Records a triangle to be drawn by the next flush
+    void submit(Vec2 v0, Vec2 v1, Vec2 v2, ColorRGB color) {
+        TriangleCommand command;
+        command.v0 = v0;
+        command.v1 = v1;
+        command.v2 = v2;
+        command.color = color;
+        m_commands.push_back(command);
+    }
+
+    // Draws every recorded triangle, returning once they are all drawn, then
+    // clears the command list
+    void flush() {
+        binCommands();
+
+        // Hand the tiles out, and draw some of them on this thread as well
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_nextTile = 0;
+            m_tilesRemaining = m_tilesX * m_tilesY;
+            ++m_frame;
+        }
+        m_wake.notify_all();
+        drawTiles();
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]() { return m_tilesRemaining == 0; });
+        }
+
+        m_commands.clear();
+    }
+
+    // Number of threads drawing tiles, including the one calling flush
+    unsigned int getNumThreads() const {
+        return m_workers.size() + 1;
+    }
+
+private:
+    // A triangle waiting to be drawn
+    struct TriangleCommand {
+        Vec2 v0, v1, v2;
+        ColorRGB color;
+    };
+
+    // Adds every command to the bin of each tile its bounding box touches
+    void binCommands() {
+        for (std::vector<unsigned int>& bin : m_bins) {
+            bin.clear();
+        }
+
+        const int maxX = m_image.getWidth() - 1;
+        const int maxY = m_image.getHeight() - 1;
+
+        for (unsigned int ii = 0; ii < m_commands.size(); ++ii) {
+            const TriangleCommand& command = m_commands[ii];
+            Vec2 tl = command.v0.min(command.v1.min(command.v2));
+            Vec2 br = command.v0.max(command.v1.max(command.v2));
+            if (br.x < 0 || br.y < 0 || tl.x > maxX || tl.y > maxY) {
+                continue;
+            }
+
+            int firstTileX = std::max(0, tl.x) / TILE_SIZE;
+            int firstTileY = std::max(0, tl.y) / TILE_SIZE;
+            int lastTileX = std::min(maxX, br.x) / TILE_SIZE;
+            int lastTileY = std::min(maxY, br.y) / TILE_SIZE;
+            for (int ty = firstTileY; ty <= lastTileY; ++ty) {
+                for (int tx = firstTileX; tx <= lastTileX; ++tx) {
+                    m_bins[ty * m_tilesX + tx].push_back(ii);
+                }
+            }
+        }
+    }
+
+    // Draws tiles until there are none left to take
+    void drawTiles() {
+        const unsigned int numTiles = m_tilesX * m_tilesY;
+        unsigned int tile;
+        while ((tile = m_nextTile.fetch_add(1)) < numTiles) {
+            Vec2 clipMin((tile % m_tilesX) * TILE_SIZE, (tile / m_tilesX) * TILE_SIZE);
+            Vec2 clipMax(std::min<int>(clipMin.x + TILE_SIZE, m_image.getWidth()) - 1,
+                         std::min<int>(clipMin.y + TILE_SIZE, m_image.getHeight()) - 1);
+
+            for (unsigned int index : m_bins[tile]) {
+                const TriangleCommand& command = m_commands[index];
+#if defined(__AVX2__)
+                // Blocks beat spans on triangles smaller than a tile, where the
+                // cost of setting up each span dominates
+                Vec2 size = command.v0.max(command.v1.max(command.v2)) - command.v0.min(command.v1.min(command.v2));
+                if (size.x < TILE_SIZE && size.y < TILE_SIZE) {
+                    fillTriangleBlock(command.v0, command.v1, command.v2, m_image, command.color, clipMin, clipMax);
+                    continue;
+                }
+#endif
+                fillTriangleEdge(command.v0, command.v1, command.v2, m_image, command.color, clipMin, clipMax);
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_tilesRemaining == 0) {
+                m_done.notify_all();
+            }
+        }
+    }
+
+    // Body of each worker thread: wait for a flush, help draw it, repeat
+    void workerLoop() {
+        unsigned int lastFrame = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this, lastFrame]() { return m_stopping || m_frame != lastFrame; });
+                if (m_stopping) {
+                    return;
+                }
+                lastFrame = m_frame;
+            }
+            drawTiles();
+        }
+    }
+
+    TGA& m_image;
+    unsigned int m_tilesX{0};
+    unsigned int m_tilesY{0};
+
+    // The command list, and the indices of the commands binned into each tile
+    std::vector<TriangleCommand> m_commands;
+    std::vector<std::vector<unsigned int>> m_bins;
+
+    // Worker threads and what they share
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    std::atomic<unsigned int> m_nextTile{0};
+    unsigned int m_tilesRemaining{0};
+    unsigned int m_frame{0};
+    bool m_stopping{false};
+};
+
+#endif
@@ -0,0 +1,160 @@
+/** @file bunny.cpp
+ *  @brief Draws a mesh onto a 4K canvas with the tiled renderer.
+ *
+ *  Draws every triangle of an .obj file (../objects/bunny.obj by default)
+ *  flat shaded onto a 3840x2160 canvas, first with a single thread and
+ *  then with the tiled renderer on more and more threads, reporting how
+ *  long each took and checking that each drew the same image. Also times
+ *  drawing the mesh in wireframe.
+ *
+ *  Compile on the terminal with:
+ *
+ *  clang++ -std=c++11 -O2 -pthread bunny.cpp -o bunny
+ *
+ *  and run with ./bunny [file.obj]
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// User libraries
+#include "GL.h"
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "ObjReader.h"
+#include "Rasterizer.h"
+#include "TileRenderer.h"
+
+// Some define values
+#define CANVAS_WIDTH 3840
+#define CANVAS_HEIGHT 2160
+#define FRAMES 10
+
+// A triangle ready to be drawn
+struct ScreenTriangle {
+    Vec2 v0, v1, v2;
+    ColorRGB color;
+};
+
+// Fits the mesh into the canvas looking down the z axis, shading each
+// triangle by how directly it faces the viewer
+std::vector<ScreenTriangle> projectMesh(const std::vector<Vec3>& positions, const std::vector<unsigned int>& indices) {
+    Vec3 lower = positions[0];
+    Vec3 upper = positions[0];
+    for (const Vec3& position : positions) {
+        lower = lower.min(position);
+        upper = upper.max(position);
+    }
+
+    // Keep the aspect ratio, leaving a small margin, and flip y so up is up
+    float scale = 0.9f * std::min(CANVAS_WIDTH / (upper.x - lower.x), CANVAS_HEIGHT / (upper.y - lower.y));
+    Vec3 center = (lower + upper) * 0.5f;
+
+    std::vector<ScreenTriangle> triangles;
+    for (unsigned int ii = 0; ii + 2 < indices.size(); ii += 3) {
+        const Vec3& p0 = positions[indices[ii]];
+        const Vec3& p1 = positions[indices[ii + 1]];
+        const Vec3& p2 = positions[indices[ii + 2]];
+
+        Vec2 screen[3];
+        const Vec3* corners[3] = {&p0, &p1, &p2};
+        for (int vv = 0; vv < 3; ++vv) {
+            screen[vv] = Vec2(CANVAS_WIDTH / 2 + (int)((corners[vv]->x - center.x) * scale),
+                              CANVAS_HEIGHT / 2 - (int)((corners[vv]->y - center.y) * scale));
+        }
+
+        float facing = std::abs((p1 - p0).cross(p2 - p0).normalized().z);
+        unsigned char shade = (unsigned char)(40 + 215 * facing);
+
+        ScreenTriangle triangle;
+        triangle.v0 = screen[0];
+        triangle.v1 = screen[1];
+        triangle.v2 = screen[2];
+        triangle.color.r = shade; triangle.color.g = shade; triangle.color.b = shade;
+        triangles.push_back(triangle);
+    }
+
+    return triangles;
+}
+
+// Main
+int main(int argc, char** argv) {
+    std::string fileName = argc > 1 ? argv[1] : "../objects/bunny.obj";
+
+    std::vector<Vec3> positions;
+    std::vector<unsigned int> indices;
+    if (!readObj(fileName, positions, indices) || positions.empty()) {
+        printf("Unable to read %s\n", fileName.c_str());
+        return 1;
+    }
+    std::vector<ScreenTriangle> triangles = projectMesh(positions, indices);
+    printf("%s: %u triangles on a %dx%d canvas, best of %d frames\n", fileName.c_str(),
+           (unsigned int)triangles.size(), CANVAS_WIDTH, CANVAS_HEIGHT, FRAMES);
+
+    // The reference: every triangle drawn in turn on this thread
+    TGA reference(CANVAS_WIDTH, CANVAS_HEIGHT);
+    double serial = 0.0;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        auto start = std::chrono::steady_clock::now();
+        for (const ScreenTriangle& triangle : triangles) {
+            fillTriangleEdge(triangle.v0, triangle.v1, triangle.v2, reference, triangle.color);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        serial = frame == 0 ? elapsed.count() : std::min(serial, elapsed.count());
+    }
+    printf("  serial       %8.2f ms\n", serial);
+
+    // The same mesh in wireframe, as glPolygonMode(LINE) would draw it
+    std::vector<Vec2> edges;
+    for (const ScreenTriangle& triangle : triangles) {
+        const Vec2 ends[6] = {triangle.v0, triangle.v1, triangle.v1, triangle.v2, triangle.v2, triangle.v0};
+        edges.insert(edges.end(), ends, ends + 6);
+    }
+    TGA wireframe(CANVAS_WIDTH, CANVAS_HEIGHT);
+    ColorRGB white;
+    white.r = white.g = white.b = 255;
+    double lines = 0.0;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        auto start = std::chrono::steady_clock::now();
+        drawLines(edges.data(), edges.size(), wireframe, white);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        lines = frame == 0 ? elapsed.count() : std::min(lines, elapsed.count());
+    }
+    printf("  wireframe    %8.2f ms\n", lines);
+
+    // Then the tiled renderer, doubling the threads up to the hardware's count
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int numThreads = 1; ; numThreads = std::min(numThreads * 2, maxThreads)) {
+        TGA canvas(CANVAS_WIDTH, CANVAS_HEIGHT);
+        TileRenderer renderer(canvas, numThreads);
+
+        double best = 0.0;
+        for (int frame = 0; frame < FRAMES; ++frame) {
+            auto start = std::chrono::steady_clock::now();
+            for (const ScreenTriangle& triangle : triangles) {
+                renderer.submit(triangle.v0, triangle.v1, triangle.v2, triangle.color);
+            }
+            renderer.flush();
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            best = frame == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+
+        bool matches = memcmp(canvas.getPixelData(), reference.getPixelData(), CANVAS_WIDTH * CANVAS_HEIGHT * 3) == 0;
+        printf("  %2u thread%s   %8.2f ms  %5.2fx  %s\n", numThreads, numThreads == 1 ? " " : "s", best,
+               serial / best, matches ? "matches serial" : "DIFFERS FROM SERIAL");
+
+        if (numThreads == maxThreads) {
+            break;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/** @file mesh.cpp
+ *  @brief Draws a mesh through the indexed draw call, with no GPU.
+ *
+ *  Reads an .obj file (../objects/house/house_obj.obj by default), packs
+ *  it into the vertex and index arrays drawIndexed takes, and draws it in
+ *  perspective onto a 1920x1080 canvas, turning it a little every frame.
+ *  Reports how long each frame took, and how many vertices the vertex
+ *  stage transformed compared to how many the triangles refer to.
+ *
+ *  Compile on the terminal with:
+ *
+ *  clang++ -std=c++11 -O2 mesh.cpp -o mesh
+ *
+ *  and run with ./mesh [file.obj]
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// User libraries
+#include "GL.h"
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "ObjReader.h"
+#include "DepthBuffer.h"
+#include "MeshRenderer.h"
+
+// Some define values
+#define CANVAS_WIDTH 1920
+#define CANVAS_HEIGHT 1080
+#define FRAMES 36
+
+// Main
+int main(int argc, char** argv) {
+    std::string fileName = argc > 1 ? argv[1] : "../objects/house/house_obj.obj";
+
+    std::vector<Vec3> positions;
+    std::vector<unsigned int> indices;
+    if (!readObj(fileName, positions, indices) || positions.empty()) {
+        printf("Unable to read %s\n", fileName.c_str());
+        return 1;
+    }
+
+    // Positions only, so three floats per vertex
+    std::vector<float> vertices;
+    Vec3 lower = positions[0];
+    Vec3 upper = positions[0];
+    for (const Vec3& position : positions) {
+        vertices.push_back(position.x);
+        vertices.push_back(position.y);
+        vertices.push_back(position.z);
+        lower = lower.min(position);
+        upper = upper.max(position);
+    }
+
+    // Move the mesh to the origin, and stand the camera back far enough to
+    // see all of it however it is turned
+    Vec3 center = (lower + upper) * 0.5f;
+    float radius = std::sqrt((upper - lower).dot(upper - lower)) * 0.5f;
+    Mat4 projection = Mat4::perspective(0.8f, (float)CANVAS_WIDTH / CANVAS_HEIGHT, radius, 5.0f * radius);
+    Mat4 view = Mat4::lookAt(Vec3(0.0f, 0.5f * radius, 3.0f * radius), Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f));
+
+    TGA canvas(CANVAS_WIDTH, CANVAS_HEIGHT);
+    DepthBuffer depth(CANVAS_WIDTH, CANVAS_HEIGHT);
+    MeshRenderer renderer(canvas, depth);
+    renderer.setLightDirection(Vec3(0.3f, 0.5f, 1.0f));
+
+    ColorRGB color;
+    color.r = 230; color.g = 200; color.b = 160;
+
+    double total = 0.0;
+    double best = 0.0;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        Mat4 model = Mat4::rotationY(frame * 2.0f * 3.14159265f / FRAMES) * Mat4::translation(center * -1.0f);
+
+        memset(canvas.getPixelData(), 128, CANVAS_WIDTH * CANVAS_HEIGHT * 3);
+        depth.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        renderer.drawIndexed(vertices.data(), 3, indices.data(), indices.size(), projection * view * model, color);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed.count();
+        best = frame == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+
+    printf("%s: %u triangles on a %dx%d canvas, %d frames\n", fileName.c_str(), (unsigned int)indices.size() / 3,
+           CANVAS_WIDTH, CANVAS_HEIGHT, FRAMES);
+    printf("  %.2f ms per frame on average, %.2f ms at best\n", total / FRAMES, best);
+    printf("  %lu vertices transformed per frame for %u indices\n", renderer.getVerticesTransformed() / FRAMES,
+           (unsigned int)indices.size());
+
+    return 0;
+}
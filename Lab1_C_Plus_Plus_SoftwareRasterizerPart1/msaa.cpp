@@ -0,0 +1,238 @@
+/** @file msaa.cpp
+ *  @brief Compares multisampling with supersampling for smoothing edges.
+ *
+ *  Draws every triangle of an .obj file (../objects/bunny.obj by default)
+ *  flat shaded, in perspective, with a depth buffer, onto a 1280x720
+ *  canvas in several ways:
+ *
+ *  - once per pixel, with jagged edges
+ *  - at twice the width and height, averaged down (4x supersampling)
+ *  - with 4 and 8 samples per pixel (4x and 8x multisampling)
+ *
+ *  and reports the time taken, the memory used, and how far the edges are
+ *  from those of a 16x supersampled image.
+ *
+ *  Compile on the terminal with:
+ *
+ *  clang++ -std=c++11 -O2 msaa.cpp -o msaa
+ *
+ *  and run with ./msaa [file.obj]
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// User libraries
+#include "GL.h"
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "ObjReader.h"
+#include "DepthBuffer.h"
+#include "MultisampleBuffer.h"
+#include "Rasterizer.h"
+
+// Some define values
+#define CANVAS_WIDTH 1280
+#define CANVAS_HEIGHT 720
+#define FRAMES 5
+
+// A triangle projected onto the canvas, still with fractional pixel
+// coordinates, and the depth of each vertex
+struct ProjectedTriangle {
+    float x[3], y[3], z[3];
+    ColorRGB color;
+};
+
+// Puts the camera in front of the mesh, far enough back to see all of it,
+// and projects every triangle in perspective, shading each by how directly
+// it faces the camera
+std::vector<ProjectedTriangle> projectMesh(const std::vector<Vec3>& positions,
+                                           const std::vector<unsigned int>& indices) {
+    Vec3 lower = positions[0];
+    Vec3 upper = positions[0];
+    for (const Vec3& position : positions) {
+        lower = lower.min(position);
+        upper = upper.max(position);
+    }
+
+    Vec3 center = (lower + upper) * 0.5f;
+    float radius = std::sqrt((upper - lower).dot(upper - lower)) * 0.5f;
+    float cameraZ = center.z + 2.0f * radius;
+    float focalLength = 0.9f * CANVAS_HEIGHT;
+
+    std::vector<ProjectedTriangle> triangles;
+    for (unsigned int ii = 0; ii + 2 < indices.size(); ii += 3) {
+        const Vec3* corners[3] = {&positions[indices[ii]], &positions[indices[ii + 1]], &positions[indices[ii + 2]]};
+
+        ProjectedTriangle triangle;
+        for (int vv = 0; vv < 3; ++vv) {
+            float distance = cameraZ - corners[vv]->z;
+            triangle.x[vv] = CANVAS_WIDTH / 2 + (corners[vv]->x - center.x) * focalLength / distance;
+            triangle.y[vv] = CANVAS_HEIGHT / 2 - (corners[vv]->y - center.y) * focalLength / distance;
+            triangle.z[vv] = depthFromDistance(distance, radius, 3.0f * radius);
+        }
+
+        float facing = std::abs((*corners[1] - *corners[0]).cross(*corners[2] - *corners[0]).normalized().z);
+        unsigned char shade = (unsigned char)(40 + 215 * facing);
+        triangle.color.r = shade; triangle.color.g = shade; triangle.color.b = shade;
+        triangles.push_back(triangle);
+    }
+
+    return triangles;
+}
+
+// Draws the triangles with one sample per pixel onto an image factor times
+// the canvas's width and height, and averages each factor x factor block
+// of pixels down into the canvas
+void drawSupersampled(const std::vector<ProjectedTriangle>& triangles, int factor, TGA& large,
+                      DepthBuffer& depth, TGA& canvas) {
+    memset(large.getPixelData(), 128, large.getWidth() * large.getHeight() * 3);
+    depth.clear();
+
+    // The center of canvas pixel x lands between the large image's pixels
+    // factor * x to factor * x + factor - 1
+    const float shift = (factor - 1) * 0.5f;
+    for (const ProjectedTriangle& triangle : triangles) {
+        Vec2 v[3];
+        for (int vv = 0; vv < 3; ++vv) {
+            v[vv] = Vec2((int)std::lround(triangle.x[vv] * factor + shift), (int)std::lround(triangle.y[vv] * factor + shift));
+        }
+        fillTriangleDepth(v[0], v[1], v[2], triangle.z[0], triangle.z[1], triangle.z[2], large, depth, triangle.color);
+    }
+
+    if (factor == 1) {
+        memcpy(canvas.getPixelData(), large.getPixelData(), CANVAS_WIDTH * CANVAS_HEIGHT * 3);
+        return;
+    }
+
+    const unsigned char* source = large.getPixelData();
+    unsigned char* pixel = canvas.getPixelData();
+    const int count = factor * factor;
+    for (int yy = 0; yy < CANVAS_HEIGHT; ++yy) {
+        for (int xx = 0; xx < CANVAS_WIDTH; ++xx, pixel += 3) {
+            for (int cc = 0; cc < 3; ++cc) {
+                int sum = 0;
+                for (int sy = 0; sy < factor; ++sy) {
+                    const unsigned char* row = source + ((yy * factor + sy) * large.getWidth() + xx * factor) * 3;
+                    for (int sx = 0; sx < factor; ++sx) {
+                        sum += row[sx * 3 + cc];
+                    }
+                }
+                pixel[cc] = (unsigned char)((sum + count / 2) / count);
+            }
+        }
+    }
+}
+
+// Draws the triangles into a multisampled buffer and resolves it into the canvas
+void drawMultisampled(const std::vector<ProjectedTriangle>& triangles, MultisampleBuffer& buffer, TGA& canvas) {
+    ColorRGB gray;
+    gray.r = gray.g = gray.b = 128;
+    buffer.clear(gray);
+
+    for (const ProjectedTriangle& triangle : triangles) {
+        Vec2 v[3];
+        for (int vv = 0; vv < 3; ++vv) {
+            v[vv] = Vec2((int)std::lround(triangle.x[vv] * RASTERIZER_SUBPIXEL_SCALE),
+                         (int)std::lround(triangle.y[vv] * RASTERIZER_SUBPIXEL_SCALE));
+        }
+        fillTriangleMultisample(v[0], v[1], v[2], triangle.z[0], triangle.z[1], triangle.z[2], buffer,
+                                triangle.color);
+    }
+
+    buffer.resolve(canvas);
+}
+
+// Average difference of each channel from the reference, over the pixels
+// where the jagged image differs from it, which lie along the edges
+double edgeError(TGA& image, TGA& jagged, TGA& reference) {
+    const unsigned char* pixels = image.getPixelData();
+    const unsigned char* jaggedPixels = jagged.getPixelData();
+    const unsigned char* referencePixels = reference.getPixelData();
+    double error = 0.0;
+    unsigned long count = 0;
+    for (unsigned int ii = 0; ii < CANVAS_WIDTH * CANVAS_HEIGHT * 3; ii += 3) {
+        if (memcmp(jaggedPixels + ii, referencePixels + ii, 3) == 0) {
+            continue;
+        }
+        for (int cc = 0; cc < 3; ++cc) {
+            error += std::abs(pixels[ii + cc] - referencePixels[ii + cc]);
+        }
+        count += 3;
+    }
+    return error / std::max(1ul, count);
+}
+
+// Main
+int main(int argc, char** argv) {
+    std::string fileName = argc > 1 ? argv[1] : "../objects/bunny.obj";
+
+    std::vector<Vec3> positions;
+    std::vector<unsigned int> indices;
+    if (!readObj(fileName, positions, indices) || positions.empty()) {
+        printf("Unable to read %s\n", fileName.c_str());
+        return 1;
+    }
+    std::vector<ProjectedTriangle> triangles = projectMesh(positions, indices);
+
+    printf("%s: %u triangles on a %dx%d canvas, best of %d frames\n", fileName.c_str(),
+           (unsigned int)triangles.size(), CANVAS_WIDTH, CANVAS_HEIGHT, FRAMES);
+
+    // The reference everything is measured against: 16 samples per pixel
+    TGA reference(CANVAS_WIDTH, CANVAS_HEIGHT);
+    {
+        TGA large(CANVAS_WIDTH * 4, CANVAS_HEIGHT * 4);
+        DepthBuffer depth(CANVAS_WIDTH * 4, CANVAS_HEIGHT * 4);
+        drawSupersampled(triangles, 4, large, depth, reference);
+    }
+    TGA jagged(CANVAS_WIDTH, CANVAS_HEIGHT);
+
+    const char* names[] = {"1 sample", "4x SSAA", "4x MSAA", "8x MSAA"};
+    for (int method = 0; method < 4; ++method) {
+        TGA canvas(CANVAS_WIDTH, CANVAS_HEIGHT);
+        double best = 0.0;
+        double megabytes = 0.0;
+
+        for (int frame = 0; frame < FRAMES; ++frame) {
+            std::chrono::duration<double, std::milli> elapsed;
+            if (method < 2) {
+                // The color and depth of each pixel drawn, at one or four per canvas pixel
+                const int factor = method == 0 ? 1 : 2;
+                TGA large(CANVAS_WIDTH * factor, CANVAS_HEIGHT * factor);
+                DepthBuffer depth(CANVAS_WIDTH * factor, CANVAS_HEIGHT * factor);
+                megabytes = CANVAS_WIDTH * factor * CANVAS_HEIGHT * factor * (3 + sizeof(float)) / 1e6;
+
+                auto start = std::chrono::steady_clock::now();
+                drawSupersampled(triangles, factor, large, depth, canvas);
+                elapsed = std::chrono::steady_clock::now() - start;
+            } else {
+                // A color and depth per sample, and a byte per pixel marking it uniform
+                MultisampleBuffer buffer(CANVAS_WIDTH, CANVAS_HEIGHT, method == 2 ? 4 : 8);
+                megabytes = CANVAS_WIDTH * CANVAS_HEIGHT * (buffer.getSamples() * (3 + sizeof(float)) + 1) / 1e6;
+
+                auto start = std::chrono::steady_clock::now();
+                drawMultisampled(triangles, buffer, canvas);
+                elapsed = std::chrono::steady_clock::now() - start;
+            }
+            best = frame == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        }
+
+        if (method == 0) {
+            memcpy(jagged.getPixelData(), canvas.getPixelData(), CANVAS_WIDTH * CANVAS_HEIGHT * 3);
+        }
+        printf("  %-9s %8.2f ms  %6.1f MB  edge error %5.1f\n", names[method], best, megabytes,
+               edgeError(canvas, jagged, reference));
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/** @file overdraw.cpp
+ *  @brief Draws a mesh with a depth buffer, to see how much overdraw costs.
+ *
+ *  Draws every triangle of an .obj file (../objects/chapel/chapel_obj.obj
+ *  by default) flat shaded, in perspective, onto a 1920x1080 canvas with
+ *  a depth buffer. The triangles are drawn nearest first and then farthest
+ *  first. Drawn nearest first, most of the hidden triangles are skipped a
+ *  whole depth tile at a time, and the time taken follows the number of
+ *  visible pixels rather than the total area of the triangles.
+ *
+ *  Compile on the terminal with:
+ *
+ *  clang++ -std=c++11 -O2 overdraw.cpp -o overdraw
+ *
+ *  and run with ./overdraw [file.obj]
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// User libraries
+#include "GL.h"
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "ObjReader.h"
+#include "DepthBuffer.h"
+#include "Rasterizer.h"
+
+// Some define values
+#define CANVAS_WIDTH 1920
+#define CANVAS_HEIGHT 1080
+#define FRAMES 10
+
+// A triangle ready to be drawn, with the depth of each vertex
+struct ScreenTriangle {
+    Vec2 v0, v1, v2;
+    float z0, z1, z2;
+    ColorRGB color;
+};
+
+// Puts the camera in front of the mesh, far enough back to see all of it,
+// and projects every triangle in perspective, shading each by how directly
+// it faces the camera
+std::vector<ScreenTriangle> projectMesh(const std::vector<Vec3>& positions, const std::vector<unsigned int>& indices) {
+    Vec3 lower = positions[0];
+    Vec3 upper = positions[0];
+    for (const Vec3& position : positions) {
+        lower = lower.min(position);
+        upper = upper.max(position);
+    }
+
+    // The camera looks down the z axis at the center of a sphere around the
+    // mesh, with the near and far planes just in front of and behind it
+    Vec3 center = (lower + upper) * 0.5f;
+    float radius = (upper - lower).dot(upper - lower);
+    radius = std::sqrt(radius) * 0.5f;
+    float cameraZ = center.z + 2.0f * radius;
+    float nearPlane = radius;
+    float farPlane = 3.0f * radius;
+    float focalLength = 0.9f * CANVAS_HEIGHT;
+
+    std::vector<ScreenTriangle> triangles;
+    for (unsigned int ii = 0; ii + 2 < indices.size(); ii += 3) {
+        const Vec3* corners[3] = {&positions[indices[ii]], &positions[indices[ii + 1]], &positions[indices[ii + 2]]};
+
+        Vec2 screen[3];
+        float depths[3];
+        for (int vv = 0; vv < 3; ++vv) {
+            float distance = cameraZ - corners[vv]->z;
+            screen[vv] = Vec2(CANVAS_WIDTH / 2 + (int)((corners[vv]->x - center.x) * focalLength / distance),
+                              CANVAS_HEIGHT / 2 - (int)((corners[vv]->y - center.y) * focalLength / distance));
+            depths[vv] = depthFromDistance(distance, nearPlane, farPlane);
+        }
+
+        float facing = std::abs((*corners[1] - *corners[0]).cross(*corners[2] - *corners[0]).normalized().z);
+        unsigned char shade = (unsigned char)(40 + 215 * facing);
+
+        ScreenTriangle triangle;
+        triangle.v0 = screen[0];
+        triangle.v1 = screen[1];
+        triangle.v2 = screen[2];
+        triangle.z0 = depths[0];
+        triangle.z1 = depths[1];
+        triangle.z2 = depths[2];
+        triangle.color.r = shade; triangle.color.g = shade; triangle.color.b = shade;
+        triangles.push_back(triangle);
+    }
+
+    return triangles;
+}
+
+// Nearest depth of any vertex of a triangle
+float nearestDepth(const ScreenTriangle& triangle) {
+    return std::min(triangle.z0, std::min(triangle.z1, triangle.z2));
+}
+
+// Draws the triangles in the given order once per frame, returning the
+// fastest frame in milliseconds
+double timeOrder(const std::vector<ScreenTriangle>& triangles, TGA& canvas, DepthBuffer& depth,
+                 unsigned long& written) {
+    double best = 0.0;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        memset(canvas.getPixelData(), 128, CANVAS_WIDTH * CANVAS_HEIGHT * 3);
+        depth.clear();
+        written = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (const ScreenTriangle& triangle : triangles) {
+            written += fillTriangleDepth(triangle.v0, triangle.v1, triangle.v2, triangle.z0, triangle.z1, triangle.z2,
+                                         canvas, depth, triangle.color);
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = frame == 0 ? elapsed.count() : std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// Main
+int main(int argc, char** argv) {
+    std::string fileName = argc > 1 ? argv[1] : "../objects/chapel/chapel_obj.obj";
+
+    std::vector<Vec3> positions;
+    std::vector<unsigned int> indices;
+    if (!readObj(fileName, positions, indices) || positions.empty()) {
+        printf("Unable to read %s\n", fileName.c_str());
+        return 1;
+    }
+    std::vector<ScreenTriangle> triangles = projectMesh(positions, indices);
+
+    // Overdraw is the total area of the triangles over the area left visible
+    double area = 0.0;
+    for (const ScreenTriangle& triangle : triangles) {
+        Vec2 v10 = triangle.v1 - triangle.v0;
+        Vec2 v20 = triangle.v2 - triangle.v0;
+        area += std::abs((double)v10.x * v20.y - (double)v10.y * v20.x) / 2.0;
+    }
+
+    std::vector<ScreenTriangle> nearFirst = triangles;
+    std::sort(nearFirst.begin(), nearFirst.end(), [](const ScreenTriangle& a, const ScreenTriangle& b) {
+        return nearestDepth(a) < nearestDepth(b);
+    });
+    std::vector<ScreenTriangle> farFirst(nearFirst.rbegin(), nearFirst.rend());
+
+    TGA canvas(CANVAS_WIDTH, CANVAS_HEIGHT);
+    DepthBuffer depth(CANVAS_WIDTH, CANVAS_HEIGHT);
+    unsigned long visible = 0;
+    unsigned long written = 0;
+    double nearTime = timeOrder(nearFirst, canvas, depth, written);
+    for (unsigned int ii = 0; ii < CANVAS_WIDTH * CANVAS_HEIGHT; ++ii) {
+        visible += depth.getDepthData()[ii] < 1.0f;
+    }
+
+    printf("%s: %u triangles on a %dx%d canvas, best of %d frames\n", fileName.c_str(),
+           (unsigned int)triangles.size(), CANVAS_WIDTH, CANVAS_HEIGHT, FRAMES);
+    printf("  %.2f Mpixels of triangles, %.2f Mpixels visible (%.1fx overdraw)\n", area / 1e6, visible / 1e6,
+           area / std::max(1ul, visible));
+    printf("  nearest first  %8.2f ms  %10lu pixels written\n", nearTime, written);
+    double farTime = timeOrder(farFirst, canvas, depth, written);
+    printf("  farthest first %8.2f ms  %10lu pixels written\n", farTime, written);
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+/** @file textured.cpp
+ *  @brief Draws a textured mesh in perspective, with no GPU.
+ *
+ *  Reads an .obj file (../objects/house/house_obj.obj by default) with its
+ *  texture coordinates, normals and diffuse texture, and draws it through
+ *  MeshRenderer::drawIndexedTextured onto a 1920x1080 canvas, turning it a
+ *  little every frame. It does so with nearest filtering, then bilinear
+ *  filtering, then bilinear filtering with mipmaps, reporting how long a
+ *  frame takes with each, and a checksum of the last frame, which stays
+ *  the same from run to run for as long as the drawing does. The last
+ *  mipmapped frame is saved as a .tga image if a file name is given for it.
+ *
+ *  Compile on the terminal with:
+ *
+ *  clang++ -std=c++11 -O2 textured.cpp -o textured
+ *
+ *  and run with ./textured [file.obj] [frame.tga]
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// User libraries
+#include "GL.h"
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "ObjReader.h"
+#include "DepthBuffer.h"
+#include "Texture.h"
+#include "MeshRenderer.h"
+
+// Some define values
+#define CANVAS_WIDTH 1920
+#define CANVAS_HEIGHT 1080
+#define FRAMES 36
+
+// An FNV-1a hash of every pixel of an image
+unsigned int checksum(TGA& image) {
+    unsigned int hash = 2166136261u;
+    const unsigned char* data = image.getPixelData();
+    for (unsigned int ii = 0; ii < image.getWidth() * image.getHeight() * 3; ++ii) {
+        hash = (hash ^ data[ii]) * 16777619u;
+    }
+    return hash;
+}
+
+// Main
+int main(int argc, char** argv) {
+    std::string fileName = argc > 1 ? argv[1] : "../objects/house/house_obj.obj";
+
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    std::string diffuseMap;
+    if (!readTexturedObj(fileName, vertices, indices, diffuseMap) || vertices.empty()) {
+        printf("Unable to read %s\n", fileName.c_str());
+        return 1;
+    }
+
+    Texture texture;
+    if (!texture.load(diffuseMap)) {
+        printf("Unable to read the texture of %s (%s)\n", fileName.c_str(), diffuseMap.c_str());
+        return 1;
+    }
+
+    // Move the mesh to the origin, and stand the camera back far enough to
+    // see all of it however it is turned
+    Vec3 lower(vertices[0], vertices[1], vertices[2]);
+    Vec3 upper = lower;
+    for (unsigned int ii = 0; ii < vertices.size(); ii += 8) {
+        Vec3 position(vertices[ii], vertices[ii + 1], vertices[ii + 2]);
+        lower = lower.min(position);
+        upper = upper.max(position);
+    }
+    Vec3 center = (lower + upper) * 0.5f;
+    float radius = std::sqrt((upper - lower).dot(upper - lower)) * 0.5f;
+    Mat4 projection = Mat4::perspective(0.8f, (float)CANVAS_WIDTH / CANVAS_HEIGHT, radius, 5.0f * radius);
+    Mat4 view = Mat4::lookAt(Vec3(0.0f, 0.5f * radius, 3.0f * radius), Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f));
+
+    TGA canvas(CANVAS_WIDTH, CANVAS_HEIGHT);
+    DepthBuffer depth(CANVAS_WIDTH, CANVAS_HEIGHT);
+    MeshRenderer renderer(canvas, depth);
+    renderer.setLightDirection(Vec3(0.3f, 0.5f, 1.0f));
+
+    printf("%s: %u triangles, %dx%d texture, on a %dx%d canvas, %d frames\n", fileName.c_str(),
+           (unsigned int)indices.size() / 3, texture.getWidth(), texture.getHeight(), CANVAS_WIDTH, CANVAS_HEIGHT,
+           FRAMES);
+
+    const char* names[] = {"nearest", "bilinear", "mipmapped"};
+    const int filters[] = {TEXTURE_NEAREST, TEXTURE_BILINEAR, TEXTURE_BILINEAR};
+    for (int mode = 0; mode < 3; ++mode) {
+        texture.setFilter(filters[mode]);
+        texture.setMipmaps(mode == 2);
+
+        double total = 0.0;
+        for (int frame = 0; frame < FRAMES; ++frame) {
+            Mat4 model = Mat4::rotationY(frame * 2.0f * 3.14159265f / FRAMES) * Mat4::translation(center * -1.0f);
+
+            memset(canvas.getPixelData(), 128, CANVAS_WIDTH * CANVAS_HEIGHT * 3);
+            depth.clear();
+
+            auto start = std::chrono::steady_clock::now();
+            renderer.drawIndexedTextured(vertices.data(), indices.data(), indices.size(), projection * view * model,
+                                         texture);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            total += elapsed.count();
+        }
+
+        printf("  %-9s %7.2f ms per frame  checksum %08x\n", names[mode], total / FRAMES, checksum(canvas));
+    }
+
+    if (argc > 2 && !canvas.outputTGAImage(argv[2])) {
+        printf("Unable to write %s\n", argv[2]);
+        return 1;
+    }
+
+    return 0;
+}
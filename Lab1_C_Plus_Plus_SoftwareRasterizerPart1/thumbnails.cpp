@@ -0,0 +1,165 @@
+/** @file thumbnails.cpp
+ *  @brief Draws many small images at once, one RenderContext each.
+ *
+ *  Draws 256 thumbnails of an .obj file (../objects/bunny.obj by default),
+ *  each turned a little further than the last, onto one 2048x2048 image
+ *  with a depth buffer. Every thumbnail has a RenderContext of its own,
+ *  with a 128x128 viewport, so the thumbnails can be drawn on any number
+ *  of threads at once. They are drawn on one thread and then on one thread
+ *  per hardware thread, and the two images compared, as they should come
+ *  out the same. The image is saved as a .tga if a file name is given.
+ *
+ *  Compile on the terminal with:
+ *
+ *  clang++ -std=c++11 -O2 -pthread thumbnails.cpp -o thumbnails
+ *
+ *  and run with ./thumbnails [file.obj] [thumbnails.tga]
+ *
+ *  @author Simon Kay
+ *  @bug No known bugs.
+ */
+
+// C++ Standard Libraries
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// User libraries
+#include "GL.h"
+#include "Color.h"
+#include "TGA.h"
+#include "Maths.h"
+#include "ObjReader.h"
+#include "DepthBuffer.h"
+#include "RenderContext.h"
+
+// Some define values
+#define THUMBNAIL_SIZE 128
+#define THUMBNAILS_ACROSS 16
+#define THUMBNAILS (THUMBNAILS_ACROSS * THUMBNAILS_ACROSS)
+#define CANVAS_SIZE (THUMBNAIL_SIZE * THUMBNAILS_ACROSS)
+
+// A mesh, and what every thumbnail of it needs to see all of it
+struct Mesh {
+    std::vector<Vec3> positions;
+    std::vector<unsigned int> indices;
+    Vec3 center;
+    float radius;
+};
+
+// Draws one thumbnail of the mesh, turned by the given angle, through a
+// context of its own
+void drawThumbnail(const Mesh& mesh, int thumbnail, TGA& canvas, DepthBuffer& depth) {
+    RenderContext context(canvas, &depth);
+    context.setViewport(thumbnail % THUMBNAILS_ACROSS * THUMBNAIL_SIZE, thumbnail / THUMBNAILS_ACROSS * THUMBNAIL_SIZE,
+                        THUMBNAIL_SIZE, THUMBNAIL_SIZE);
+    context.setPolygonMode(FILL_EDGE);
+    context.setDepthTest(true);
+
+    const float angle = thumbnail * 2.0f * 3.14159265f / THUMBNAILS;
+    const float radius = mesh.radius;
+    Mat4 transform = Mat4::perspective(0.8f, 1.0f, radius, 5.0f * radius) *
+                     Mat4::lookAt(Vec3(0.0f, 0.5f * radius, 3.0f * radius), Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f)) *
+                     Mat4::rotationY(angle) * Mat4::translation(mesh.center * -1.0f);
+    const Vec3 light = Vec3(0.3f, 0.5f, 1.0f).normalized();
+
+    for (unsigned int ii = 0; ii + 2 < mesh.indices.size(); ii += 3) {
+        Vec2 screen[3];
+        float depths[3];
+        bool visible = true;
+        for (int vv = 0; vv < 3 && visible; ++vv) {
+            Vec4 clip = transform.transform(mesh.positions[mesh.indices[ii + vv]]);
+            visible = clip.w > 0.0f && clip.z >= 0.0f && clip.z <= clip.w;
+            screen[vv] = Vec2((int)((clip.x / clip.w + 1.0f) * 0.5f * THUMBNAIL_SIZE),
+                              (int)((1.0f - clip.y / clip.w) * 0.5f * THUMBNAIL_SIZE));
+            depths[vv] = clip.z / clip.w;
+        }
+        if (!visible) {
+            continue;
+        }
+
+        const Vec3& p0 = mesh.positions[mesh.indices[ii]];
+        const Vec3& p1 = mesh.positions[mesh.indices[ii + 1]];
+        const Vec3& p2 = mesh.positions[mesh.indices[ii + 2]];
+        float facing = std::abs((p1 - p0).cross(p2 - p0).normalized().dot(light));
+        ColorRGB color;
+        color.r = (unsigned char)(60 + 190 * facing);
+        color.g = (unsigned char)(40 + 150 * facing);
+        color.b = (unsigned char)(30 + 100 * facing);
+
+        context.drawTriangle(screen[0], screen[1], screen[2], depths[0], depths[1], depths[2], color);
+    }
+}
+
+// Draws every thumbnail, sharing them out between the given number of
+// threads, and returns the time taken in milliseconds
+double drawThumbnails(const Mesh& mesh, unsigned int numThreads, TGA& canvas, DepthBuffer& depth) {
+    memset(canvas.getPixelData(), 128, CANVAS_SIZE * CANVAS_SIZE * 3);
+    depth.clear();
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        for (int thumbnail = next++; thumbnail < THUMBNAILS; thumbnail = next++) {
+            drawThumbnail(mesh, thumbnail, canvas, depth);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int ii = 1; ii < numThreads; ++ii) {
+        threads.push_back(std::thread(work));
+    }
+    work();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Main
+int main(int argc, char** argv) {
+    std::string fileName = argc > 1 ? argv[1] : "../objects/bunny.obj";
+
+    Mesh mesh;
+    if (!readObj(fileName, mesh.positions, mesh.indices) || mesh.positions.empty()) {
+        printf("Unable to read %s\n", fileName.c_str());
+        return 1;
+    }
+    Vec3 lower = mesh.positions[0];
+    Vec3 upper = mesh.positions[0];
+    for (const Vec3& position : mesh.positions) {
+        lower = lower.min(position);
+        upper = upper.max(position);
+    }
+    mesh.center = (lower + upper) * 0.5f;
+    mesh.radius = std::sqrt((upper - lower).dot(upper - lower)) * 0.5f;
+
+    const unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    printf("%s: %d thumbnails of %u triangles, %dx%d each\n", fileName.c_str(), THUMBNAILS,
+           (unsigned int)mesh.indices.size() / 3, THUMBNAIL_SIZE, THUMBNAIL_SIZE);
+
+    TGA single(CANVAS_SIZE, CANVAS_SIZE);
+    TGA threaded(CANVAS_SIZE, CANVAS_SIZE);
+    DepthBuffer depth(CANVAS_SIZE, CANVAS_SIZE);
+    double singleTime = drawThumbnails(mesh, 1, single, depth);
+    double threadedTime = drawThumbnails(mesh, numThreads, threaded, depth);
+    bool same = memcmp(single.getPixelData(), threaded.getPixelData(), CANVAS_SIZE * CANVAS_SIZE * 3) == 0;
+
+    printf("  1 thread    %8.2f ms\n", singleTime);
+    printf("  %-2u threads  %8.2f ms  (%.1fx), %s\n", numThreads, threadedTime, singleTime / threadedTime,
+           same ? "same image" : "IMAGES DIFFER");
+
+    if (argc > 2 && !threaded.outputTGAImage(argv[2])) {
+        printf("Unable to write %s\n", argv[2]);
+        return 1;
+    }
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include "FrameSink.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+FrameSink::FrameSink(const std::string& path, Format format, const QSize& size, int framesPerSecond) :
+  file_(nullptr), format_(format), size_(size), frameCount_(0), stopping_(false), failed_(false)
+{
+  if (path == "-") {
+#ifdef _WIN32
+    // Stop Windows from turning every \n in the frames into \r\n
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    file_ = stdout;
+  } else {
+    file_ = fopen(path.c_str(), "wb");
+  }
+  if (file_ == nullptr) {
+    failed_ = true;
+    return;
+  }
+  setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+
+  if (format_ == Format::Y4M) {
+    // Progressive frames, square pixels, full resolution color
+    failed_ = fprintf(file_, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n",
+                      size_.width(), size_.height(), framesPerSecond) < 0;
+  }
+
+  thread_ = std::thread(&FrameSink::run, this);
+}
+
+FrameSink::~FrameSink()
+{
+  close();
+}
+
+bool FrameSink::close()
+{
+  if (file_ == nullptr) {
+    return good();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queued_.notify_one();
+  thread_.join();
+
+  bool closed = file_ == stdout ? fflush(file_) == 0 : fclose(file_) == 0;
+  file_ = nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  failed_ = failed_ || !closed;
+  return !failed_;
+}
+
+FrameSink::Format FrameSink::formatFor(const std::string& path)
+{
+  std::string extension = path.size() >= 4 ? path.substr(path.size() - 4) : "";
+  return extension == ".rgb" || extension == ".raw" ? Format::Raw : Format::Y4M;
+}
+
+bool FrameSink::good() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !failed_;
+}
+
+void FrameSink::write(const QImage& frame)
+{
+  if (file_ == nullptr || frame.size() != size_) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  taken_.wait(lock, [this] { return (int)queue_.size() < MAX_QUEUED; });
+  queue_.push_back(frame);
+  frameCount_++;
+  lock.unlock();
+  queued_.notify_one();
+}
+
+void FrameSink::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queued_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      break;
+    }
+
+    QImage frame = std::move(queue_.front());
+    queue_.pop_front();
+    bool failed = failed_;
+    lock.unlock();
+    taken_.notify_one();
+
+    // Once a write has failed the rest of the frames are only taken off
+    // the queue, so write() never waits on a writer that has given up
+    bool written = failed || writeFrame(frame);
+
+    lock.lock();
+    failed_ = failed_ || !written;
+  }
+}
+
+bool FrameSink::writeFrame(const QImage& frame)
+{
+  QImage rgb = frame.format() == QImage::Format_RGB888 ? frame : frame.convertToFormat(QImage::Format_RGB888);
+  const int width = size_.width();
+  const int height = size_.height();
+
+  if (format_ == Format::Raw) {
+    for (int y = 0; y < height; ++y) {
+      if (fwrite(rgb.constScanLine(y), 3, width, file_) != (size_t)width) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The BT.601 conversion to studio range Y'CbCr that Y4M files are read
+  // with by default, in 8 bit fixed point
+  planes_.resize(width * height * 3);
+  uchar* yPlane = planes_.data();
+  uchar* cbPlane = yPlane + width * height;
+  uchar* crPlane = cbPlane + width * height;
+  for (int y = 0; y < height; ++y) {
+    const uchar* pixel = rgb.constScanLine(y);
+    for (int x = 0; x < width; ++x, pixel += 3) {
+      const int r = pixel[0], g = pixel[1], b = pixel[2];
+      const int index = y * width + x;
+      yPlane[index] = (uchar)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+      cbPlane[index] = (uchar)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+      crPlane[index] = (uchar)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+  }
+
+  return fputs("FRAME\n", file_) >= 0 && fwrite(planes_.data(), 1, planes_.size(), file_) == planes_.size();
+}
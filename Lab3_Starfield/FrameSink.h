@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QtGui>
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Streams rendered frames out to a video file, or to stdout to be piped
+ * into an encoder, so an animation can be rendered in a batch rather than
+ * watched in a window.
+ *
+ * Frames are written in one of two formats:
+ *
+ *   Y4M  the YUV4MPEG2 format most encoders and players read without being
+ *        told anything else about it, e.g. ffmpeg -i frames.y4m out.mp4.
+ *        Pixels are stored as full resolution Y, Cb and Cr planes (4:4:4).
+ *   Raw  packed 8 bit R, G, B pixels one frame after another, with nothing
+ *        else, e.g. ffmpeg -f rawvideo -pix_fmt rgb24 -s 800x600 -r 60 -i -
+ *
+ * Writing happens on a thread of its own. write() only queues the frame,
+ * so rendering goes on while earlier frames are converted and written.
+ * The queued QImage shares the renderer's pixels at first, but QImage
+ * copies on write, so the renderer's next change to its image copies the
+ * whole frame. Each frame therefore costs one copy on the rendering
+ * thread, though none of the conversion or writing. The queue holds
+ * at most a few frames; should the disk fall that far behind, write()
+ * waits for room rather than drop a frame or let the queue grow without
+ * end.
+ */
+class FrameSink
+{
+public:
+  enum class Format { Y4M, Raw };
+
+  // Frames queued before write() waits for the writer to catch up
+  static const int MAX_QUEUED = 8;
+
+  // Opens the file at path, or stdout if path is "-", for frames of the
+  // given size shown at the given rate.
+  FrameSink(const std::string& path, Format format, const QSize& size, int framesPerSecond);
+
+  // Closes the file, if close() has not already.
+  ~FrameSink();
+
+  // The format given by the path's extension: Raw for .rgb or .raw,
+  // otherwise Y4M.
+  static Format formatFor(const std::string& path);
+
+  // Whether the file was opened, and every frame so far written.
+  bool good() const;
+
+  // Queues a frame. Frames of the wrong size are skipped.
+  void write(const QImage& frame);
+
+  // Number of frames queued so far.
+  unsigned int frameCount() const { return frameCount_; }
+
+  // Waits for every queued frame to be written, and closes the file.
+  // Returns whether every frame was written.
+  bool close();
+
+private:
+  void run();
+  bool writeFrame(const QImage& frame);
+
+  FILE* file_;
+  Format format_;
+  QSize size_;
+  unsigned int frameCount_;
+
+  // Guards the queue and the flags after it
+  mutable std::mutex mutex_;
+  std::condition_variable queued_;
+  std::condition_variable taken_;
+  std::deque<QImage> queue_;
+  bool stopping_;
+  bool failed_;
+
+  // The Y, Cb and Cr planes of the frame being written, only touched by
+  // the writer thread
+  std::vector<uchar> planes_;
+
+  std::thread thread_;
+};
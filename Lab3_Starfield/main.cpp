@@ -6,10 +6,62 @@
 #include <QtGui>
 #include <QtOpenGL>
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
 // Lab application
 #include "Lab2.h"
+#include "FrameSink.h"
+#include "StarList.h"
+
+// Renders the starfield into a video rather than a window, moving the stars
+// as far each frame as the widget does, as fast as it can. Run as
+//
+//   Lab2 --frames 600 --output stars.y4m
+//
+// with an output of "-" for stdout, or ending in .rgb for raw frames.
+int renderFrames(int frames, const std::string& output) {
+  const int framesPerSecond = 60;
+  const QSize size(800, 600);
+
+  QImage image(size, QImage::Format_RGB888);
+  StarList stars(2400, 1.0, 1.5);
+  FrameSink sink(output, FrameSink::formatFor(output), size, framesPerSecond);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames && sink.good(); ++frame) {
+    image.fill(QColor(0, 0, 0));
+    stars.updateAndRender(image, 0.001, size);
+    sink.write(image);
+  }
+  float rendered = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+  if (!sink.close()) {
+    fprintf(stderr, "Unable to write %s\n", output.c_str());
+    return 1;
+  }
+  float written = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+  fprintf(stderr, "%u frames rendered in %.2f s, and written in %.2f s\n", sink.frameCount(), rendered, written);
+  return 0;
+}
 
 int main(int argc, char** argv) {
+  int frames = 0;
+  std::string output;
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (strcmp(argv[i], "--frames") == 0) {
+      frames = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--output") == 0) {
+      output = argv[++i];
+    }
+  }
+  if (frames > 0 && !output.empty()) {
+    return renderFrames(frames, output);
+  }
+
   QApplication a(argc, argv);
   QString appDir = a.applicationDirPath();
   QDir::setCurrent(appDir);
@@ -1,10 +1,9 @@
 #include "BasicWidget.h"
 
-BasicWidget::BasicWidget(QWidget* parent) : QWidget(parent), buffer_(800, 600), minYVert_(-1, -1, 0), midYVert_(0, 1, 0), maxYVert_(1, -1, 0)
+BasicWidget::BasicWidget(QWidget* parent) : QWidget(parent), renderer_(this)
 {
-  prevTicks_ = QDateTime::currentMSecsSinceEpoch();
-  yAxisRotation_ = 0.0f;
-  projection_.InitPerspective(90.0f, 800./600., 0.1f, 1000.0f);
+  // Every pixel is painted each frame, so Qt need not clear the background first
+  setAttribute(Qt::WA_OpaquePaintEvent);
 }
 
 BasicWidget::~BasicWidget()
@@ -13,35 +12,20 @@ BasicWidget::~BasicWidget()
 void BasicWidget::resizeEvent(QResizeEvent* event)
 {
   QWidget::resizeEvent(event);
-  buffer_.setSize(size());
-  projection_.InitPerspective(90.0f, width() / height(), 0.1, 1000.0);
+  renderer_.setSize(size());
 }
 
 void BasicWidget::paintEvent(QPaintEvent* event)
 {
   Q_UNUSED(event);
 
-  qint64 curTicks = QDateTime::currentMSecsSinceEpoch();
-  float delta = (float)((curTicks - prevTicks_) / 1000.0);
-
-  yAxisRotation_ += delta;
-
-  // We have some transformations now.  Construct them
-  translation_.InitTranslation(0.0, 0.0, 3.0);
-  rotation_.InitRotation(0.0, yAxisRotation_, 0.0);
-
-  transform_ = projection_.Multiply(translation_.Multiply(rotation_));
-
-  buffer_.clearImage();
-  Vertex v0 = maxYVert_.Transform(transform_);
-  Vertex v1 = midYVert_.Transform(transform_);
-  Vertex v2 = minYVert_.Transform(transform_);
-  buffer_.FillTriangle(v0, v1, v2);
-
+  // Draw the newest finished frame straight from the render thread's buffer.
+  // The render thread asks for the next repaint when it has another frame.
   QPainter painter(this);
-  QImage image = buffer_.image();
-  QPixmap pixmap = QPixmap::fromImage(image);
-  painter.drawPixmap(0, 0, pixmap);
-  prevTicks_ = curTicks;
-  update();
+  painter.drawImage(0, 0, renderer_.acquireFrame());
+
+  painter.setPen(Qt::white);
+  painter.drawText(10, 20, QString("%1 ms per frame, %2 frames dropped")
+                               .arg(renderer_.frameMilliseconds(), 0, 'f', 2)
+                               .arg(renderer_.droppedFrames()));
 }
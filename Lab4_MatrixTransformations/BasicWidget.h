@@ -4,29 +4,18 @@
 #include <QtWidgets>
 #include <QtOpenGL>
 
-#include "ScanBuffer.h"
-#include "Matrix4f.h"
-#include "Vertex.h"
+#include "RenderThread.h"
 
 /**
- * This is just a basic OpenGL widget that will allow a change of background color.
+ * This is just a basic widget that shows the frames of a software renderer.
+ * The rendering itself happens on a RenderThread.
  */
 class BasicWidget : public QWidget
 {
   Q_OBJECT
 
 protected:
-  QColor backgroundColor_;
-  ScanBuffer buffer_;
-  qint64 prevTicks_;
-  float yAxisRotation_;
-  Matrix4f translation_;
-  Matrix4f rotation_;
-  Matrix4f transform_;
-  Matrix4f projection_;
-  Vertex minYVert_;
-  Vertex midYVert_;
-  Vertex maxYVert_;
+  RenderThread renderer_;
   
   // Paint our image.
   void paintEvent(QPaintEvent* event) Q_DECL_OVERRIDE;
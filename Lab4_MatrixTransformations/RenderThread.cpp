@@ -0,0 +1,95 @@
+#include "RenderThread.h"
+
+constexpr std::chrono::milliseconds RenderThread::FRAME_INTERVAL;
+
+RenderThread::RenderThread(QWidget* widget) : widget_(widget),
+  buffers_{ScanBuffer(800, 600), ScanBuffer(800, 600), ScanBuffer(800, 600)},
+  back_(0), front_(1), ready_(2), width_(800), height_(600), frameMilliseconds_(0.0f), droppedFrames_(0),
+  stopping_(false)
+{
+  for (ScanBuffer& buffer : buffers_) {
+    buffer.setSize(QSize(800, 600));
+  }
+
+  thread_ = std::thread(&RenderThread::run, this);
+}
+
+RenderThread::~RenderThread()
+{
+  stopping_.store(true);
+  thread_.join();
+}
+
+void RenderThread::setSize(const QSize& size)
+{
+  width_.store(size.width());
+  height_.store(size.height());
+}
+
+const QImage& RenderThread::acquireFrame()
+{
+  // Swap the front buffer for the newest frame, handing the old one back
+  if (ready_.load() & NEW_FRAME) {
+    front_ = ready_.exchange(front_) & ~NEW_FRAME;
+  }
+  return buffers_[front_].image();
+}
+
+void RenderThread::run()
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point nextFrame = start;
+
+  while (!stopping_.load()) {
+    std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+    renderFrame(buffers_[back_], std::chrono::duration<float>(frameStart - start).count());
+    frameMilliseconds_.store(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+
+    // Publish the frame, and take back whichever buffer was waiting. If the
+    // widget had not yet taken the frame in it, that frame is dropped.
+    int previous = ready_.exchange(back_ | NEW_FRAME);
+    if (previous & NEW_FRAME) {
+      droppedFrames_++;
+    }
+    back_ = previous & ~NEW_FRAME;
+    QMetaObject::invokeMethod(widget_, "update", Qt::QueuedConnection);
+
+    // Wait for the next frame, without trying to catch up on missed ones
+    nextFrame = std::max(nextFrame + FRAME_INTERVAL, std::chrono::steady_clock::now());
+    std::this_thread::sleep_until(nextFrame);
+  }
+}
+
+void RenderThread::renderFrame(ScanBuffer& buffer, float seconds)
+{
+  QSize size(width_.load(), height_.load());
+  if (size.width() <= 0 || size.height() <= 0) {
+    return;
+  }
+  if (buffer.size() != size) {
+    buffer.setSize(size);
+  }
+  renderScene(buffer, seconds);
+}
+
+void RenderThread::renderScene(ScanBuffer& buffer, float seconds)
+{
+  QSize size = buffer.size();
+  Matrix4f projection;
+  projection.InitPerspective(90.0f, (float)size.width() / size.height(), 0.1f, 1000.0f);
+
+  // We have some transformations now.  Construct them
+  Matrix4f translation;
+  Matrix4f rotation;
+  translation.InitTranslation(0.0, 0.0, 3.0);
+  rotation.InitRotation(0.0, seconds, 0.0);
+  Matrix4f transform = projection.Multiply(translation.Multiply(rotation));
+
+  // Red, green and blue corners, blended across the triangle
+  Vertex minYVert(Vector4f(-1, -1, 0, 1), Vector4f(1.0f, 0.0f, 0.0f, 1.0f));
+  Vertex midYVert(Vector4f(0, 1, 0, 1), Vector4f(0.0f, 1.0f, 0.0f, 1.0f));
+  Vertex maxYVert(Vector4f(1, -1, 0, 1), Vector4f(0.0f, 0.0f, 1.0f, 1.0f));
+
+  buffer.clearImage();
+  buffer.FillTriangle(maxYVert.Transform(transform), midYVert.Transform(transform), minYVert.Transform(transform));
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QtGui>
+#include <QtWidgets>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ScanBuffer.h"
+#include "Matrix4f.h"
+#include "Vertex.h"
+
+/**
+ * Rasterizes the spinning triangle on a thread of its own, so the GUI
+ * thread only ever has to show finished frames.
+ *
+ * Frames are triple buffered. The render thread draws into the back
+ * buffer, the widget shows the front buffer, and the third holds the
+ * newest finished frame. Handing a frame over in either direction is a
+ * single atomic exchange of buffer indices, so neither thread ever waits
+ * for the other, and no frame is ever copied.
+ */
+class RenderThread
+{
+public:
+  // Frames are rendered at most this often
+  static constexpr std::chrono::milliseconds FRAME_INTERVAL{16};
+
+  // Starts rendering straight away, asking the widget to repaint whenever
+  // a frame is finished.
+  RenderThread(QWidget* widget);
+  ~RenderThread();
+
+  // Sets the size of the frames to come. Safe to call from any thread.
+  void setSize(const QSize& size);
+
+  // Takes the newest finished frame if there is one, and returns the frame
+  // to show, which stays valid until the next call. Call from the GUI thread.
+  const QImage& acquireFrame();
+
+  // How long the last frame took to rasterize, in milliseconds.
+  float frameMilliseconds() const { return frameMilliseconds_.load(); }
+
+  // How many finished frames were replaced by newer ones before they were shown.
+  unsigned int droppedFrames() const { return droppedFrames_.load(); }
+
+  // Draws the scene as it is the given number of seconds in, at the
+  // buffer's size. The widget's frames and batch renders both use this.
+  static void renderScene(ScanBuffer& buffer, float seconds);
+
+private:
+  // Set alongside a buffer index in ready_ while that frame is yet to be shown.
+  static const int NEW_FRAME = 4;
+
+  void run();
+  void renderFrame(ScanBuffer& buffer, float seconds);
+
+  QWidget* widget_;
+  ScanBuffer buffers_[3];
+  int back_;
+  int front_;
+  std::atomic<int> ready_;
+
+  std::atomic<int> width_;
+  std::atomic<int> height_;
+  std::atomic<float> frameMilliseconds_;
+  std::atomic<unsigned int> droppedFrames_;
+  std::atomic<bool> stopping_;
+
+  std::thread thread_;
+};
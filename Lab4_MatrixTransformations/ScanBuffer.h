@@ -3,6 +3,12 @@
 #include <QtCore>
 #include <QtGui>
 
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "Vertex.h"
 #include "Matrix4f.h"
 #include "Vector4f.h"
@@ -15,6 +21,8 @@ public:
     for(int i =0; i < height; i++){
       m_scanBufferMin.push_back(0);
       m_scanBufferMax.push_back(0);
+      m_colorMin.push_back(Vector4f(1.0f));
+      m_colorMax.push_back(Vector4f(1.0f));
     }
   }    
 
@@ -26,17 +34,103 @@ public:
   }
 
   void FillShape(int yMin, int yMax){
-    for(int j = yMin; j < yMax; j++){
-      // Get the min and hte max value at the y-position
-      int xMin = m_scanBufferMin[j];
-	  int xMax = m_scanBufferMax[j];
-            
+	FillShape(yMin, yMax, QColor(255, 255, 255));
+  }
+
+  // Fills every span from yMin up to yMax with one color.
+  // Rows are written straight through a pointer to the image's pixels
+  // rather than a pixel at a time through setPixelColor, which checks
+  // bounds and converts formats for every pixel.
+  void FillShape(int yMin, int yMax, QColor color){
+	yMin = qMax(yMin, 0);
+	yMax = qMin(yMax, image_.height());
+	uchar* bits = image_.bits();
+	int bytesPerLine = image_.bytesPerLine();
+
+	for(int j = yMin; j < yMax; j++){
+	  // Get the min and the max value at the y-position
+	  int xMin = qMax(m_scanBufferMin[j], 0);
+	  int xMax = qMin(m_scanBufferMax[j], image_.width());
+	  if(xMin < xMax){
+		FillSpan(bits + j * bytesPerLine + xMin * 3, xMax - xMin, color);
+	  }
+	}
+  }
+
+  // Fills every span from yMin up to yMax, blending across each span from
+  // the color at its start to the color at its end (Gouraud shading).
+  void FillShadedShape(int yMin, int yMax){
+	yMin = qMax(yMin, 0);
+	yMax = qMin(yMax, image_.height());
+	uchar* bits = image_.bits();
+	int bytesPerLine = image_.bytesPerLine();
+
+	for(int j = yMin; j < yMax; j++){
+	  int xStart = m_scanBufferMin[j];
+	  int xEnd = m_scanBufferMax[j];
+	  if(xStart >= xEnd){
+		continue;
+	  }
+
+	  // Colors are stepped in 16.16 fixed point, out of 255
+	  Vector4f start = m_colorMin[j].Mul(255.0f * 65536.0f);
+	  Vector4f step = m_colorMax[j].Mul(255.0f * 65536.0f).Sub(start).Div((float)(xEnd - xStart));
+	  int r = (int)start.GetX();
+	  int g = (int)start.GetY();
+	  int b = (int)start.GetZ();
+	  int rStep = (int)step.GetX();
+	  int gStep = (int)step.GetY();
+	  int bStep = (int)step.GetZ();
+
+	  // Skip whatever lies off the image
+	  int xMin = qMax(xStart, 0);
+	  int xMax = qMin(xEnd, image_.width());
+	  r += rStep * (xMin - xStart);
+	  g += gStep * (xMin - xStart);
+	  b += bStep * (xMin - xStart);
+
+	  uchar* pixel = bits + j * bytesPerLine + xMin * 3;
 	  for(int i = xMin; i < xMax; i++){
-		image_.setPixelColor(i, j, QColor(255, 255, 255));
+		pixel[0] = (uchar)(r >> 16);
+		pixel[1] = (uchar)(g >> 16);
+		pixel[2] = (uchar)(b >> 16);
+		pixel += 3;
+		r += rStep;
+		g += gStep;
+		b += bStep;
 	  }
 	}
   }
 
+  // Sets count consecutive RGB888 pixels to one color.
+  static void FillSpan(uchar* pixel, int count, QColor color){
+	// Sixteen pixels are 48 bytes, a whole number of 16-byte blocks
+	uchar pattern[48];
+	for(int i = 0; i < 48; i += 3){
+	  pattern[i] = (uchar)color.red();
+	  pattern[i + 1] = (uchar)color.green();
+	  pattern[i + 2] = (uchar)color.blue();
+	}
+
+#if defined(__SSE2__)
+	__m128i block0 = _mm_loadu_si128((const __m128i*)pattern);
+	__m128i block1 = _mm_loadu_si128((const __m128i*)(pattern + 16));
+	__m128i block2 = _mm_loadu_si128((const __m128i*)(pattern + 32));
+	for(; count >= 16; count -= 16){
+	  _mm_storeu_si128((__m128i*)pixel, block0);
+	  _mm_storeu_si128((__m128i*)(pixel + 16), block1);
+	  _mm_storeu_si128((__m128i*)(pixel + 32), block2);
+	  pixel += 48;
+	}
+#else
+	for(; count >= 16; count -= 16){
+	  std::memcpy(pixel, pattern, 48);
+	  pixel += 48;
+	}
+#endif
+	std::memcpy(pixel, pattern, count * 3);
+  }
+
     
   // whichSide -- means which side of
   // scanbuffer(min or max) are we drawing on.
@@ -60,15 +154,22 @@ public:
 	
 	// Where we start from
 	float curX = (float)xStart;
+
+	// The color is stepped down the edge the same way
+	Vector4f curColor = minYVert.GetColor();
+	Vector4f colorStep = maxYVert.GetColor().Sub(curColor).Div((float)yDist);
 	
 	for(int j = yStart; j < yEnd; j++){
 	  if(whichSide==0){
 		m_scanBufferMin[j] = curX;
+		m_colorMin[j] = curColor;
 	  }else{
 		m_scanBufferMax[j] = curX;
+		m_colorMax[j] = curColor;
 	  }
       
 	  curX += xStep;
+	  curColor = curColor.Add(colorStep);
 	}
 	
   }
@@ -80,7 +181,83 @@ public:
   }
   
   
+  // Takes a triangle in clip space, i.e. transformed but not yet divided
+  // by w, and clips it to the view frustum before filling it.
   void FillTriangle(Vertex v1, Vertex v2, Vertex v3){
+	int code1 = v1.ClipOutcode();
+	int code2 = v2.ClipOutcode();
+	int code3 = v3.ClipOutcode();
+
+	// Trivially accept: every vertex is inside, so there is nothing to clip
+	if((code1 | code2 | code3) == 0){
+	  FillClippedTriangle(v1, v2, v3);
+	  return;
+	}
+
+	// Trivially reject: every vertex is outside the same plane
+	if((code1 & code2 & code3) != 0){
+	  return;
+	}
+
+	// Otherwise clip the triangle against each plane it crosses, which
+	// leaves a convex polygon of up to nine vertices, and fill that as a fan
+	QVector<Vertex> vertices;
+	vertices.push_back(v1);
+	vertices.push_back(v2);
+	vertices.push_back(v3);
+	if(!ClipPolygon(vertices, code1 | code2 | code3)){
+	  return;
+	}
+
+	for(int i = 1; i < vertices.size() - 1; i++){
+	  FillClippedTriangle(vertices[0], vertices[i], vertices[i + 1]);
+	}
+  }
+
+  // Sutherland-Hodgman clipping: clips the polygon against each plane of
+  // the view frustum whose bit is set in planes, one plane at a time.
+  // Returns false if nothing is left.
+  bool ClipPolygon(QVector<Vertex>& vertices, int planes){
+	QVector<Vertex> clipped;
+	for(int plane = 0; plane < 6; plane++){
+	  if((planes & (1 << plane)) == 0){
+		continue;
+	  }
+
+	  // Even planes keep -w <= component, odd ones component <= w
+	  int componentIndex = plane / 2;
+	  float componentFactor = (plane % 2 == 0) ? -1.0f : 1.0f;
+
+	  clipped.clear();
+	  Vertex previous = vertices.last();
+	  float previousDistance = previous.GetW() - previous.Get(componentIndex) * componentFactor;
+	  for(int i = 0; i < vertices.size(); i++){
+		Vertex current = vertices[i];
+		float currentDistance = current.GetW() - current.Get(componentIndex) * componentFactor;
+
+		// Where an edge crosses the plane, keep the point it crosses at
+		if((previousDistance >= 0) != (currentDistance >= 0)){
+		  float amount = previousDistance / (previousDistance - currentDistance);
+		  clipped.push_back(previous.Lerp(current, amount));
+		}
+		if(currentDistance >= 0){
+		  clipped.push_back(current);
+		}
+
+		previous = current;
+		previousDistance = currentDistance;
+	  }
+
+	  vertices.swap(clipped);
+	  if(vertices.size() < 3){
+		return false;
+	  }
+	}
+	return true;
+  }
+
+  // Fills a triangle that lies wholly inside the view frustum.
+  void FillClippedTriangle(Vertex v1, Vertex v2, Vertex v3){
 	
 	// 3 vertices -- assume sorted order
 	Matrix4f screenSpaceTransform;
@@ -116,14 +293,28 @@ public:
 	
 	// Draw 3 lines and fill them in.
 	ScanConvertTriangle(minYVert,midYVert,maxYVert,handedness);
-	FillShape(minYVert.GetY(),maxYVert.GetY()); 
+
+	// A triangle of one color takes the faster flat fill
+	Vector4f color = minYVert.GetColor();
+	if(color.Equals(midYVert.GetColor()) && color.Equals(maxYVert.GetColor())){
+	  Vector4f rgb = color.Mul(255.0f);
+	  FillShape(minYVert.GetY(), maxYVert.GetY(), QColor((int)rgb.GetX(), (int)rgb.GetY(), (int)rgb.GetZ()));
+	}else{
+	  FillShadedShape(minYVert.GetY(), maxYVert.GetY());
+	}
   }
 
-  QImage image() const {return image_;}
+  // The image is returned by reference, so showing it never copies it
+  const QImage& image() const {return image_;}
+  QSize size() const {return size_;}
   void clearImage() {image_.fill(QColor(0,0,0));}
   void setSize(const QSize& size) { 
 	  size_ = size; 
 	  image_ = image_.scaled(size);
+	  m_scanBufferMin.fill(0, size.height());
+	  m_scanBufferMax.fill(0, size.height());
+	  m_colorMin.fill(Vector4f(1.0f), size.height());
+	  m_colorMax.fill(Vector4f(1.0f), size.height());
 	  clearImage();
   }
 
@@ -132,4 +323,6 @@ private:
   QSize size_;
   QVector<int> m_scanBufferMin;
   QVector<int> m_scanBufferMax;
+  QVector<Vector4f> m_colorMin;
+  QVector<Vector4f> m_colorMax;
 };
@@ -3,6 +3,15 @@
 #include "Vector4f.h"
 #include "Matrix4f.h"
 
+// Outcode bits, one for each plane of the view frustum.
+// Bit 2 * axis is set below -w on that axis, and bit 2 * axis + 1 above w.
+#define CLIP_LEFT   1
+#define CLIP_RIGHT  2
+#define CLIP_BOTTOM 4
+#define CLIP_TOP    8
+#define CLIP_NEAR   16
+#define CLIP_FAR    32
+
 class Vertex{
 
 public:
@@ -26,20 +35,27 @@ public:
 	Vertex(Vector4f pos){
 		m_pos = pos;
 	}
+
+	// Initialize a vertex with a position and a color
+	Vertex(Vector4f pos, Vector4f color){
+		m_pos = pos;
+		m_color = color;
+	}
  
 	// How we will move vertices around.
 	// Essentially return a new vertex that is transformed.
+	// The color goes along unchanged.
 	Vertex Transform(Matrix4f transform){
-		return transform.Transform(m_pos);
+		return Vertex(transform.Transform(m_pos), m_color);
 	}
 
 	// Need to divide by 'w' to put into perspective
 	// of each of our vertices.
 	Vertex PerspectiveDivide(){
-		return Vertex(	m_pos.GetX() / m_pos.GetW(),
+		return Vertex(	Vector4f(m_pos.GetX() / m_pos.GetW(),
 						m_pos.GetY() / m_pos.GetW(),
 						m_pos.GetZ() / m_pos.GetW(),
-						m_pos.GetW()); // NOTE: We are not dividing 'w' by 'w'
+						m_pos.GetW()), m_color); // NOTE: We are not dividing 'w' by 'w'
 										// We typically keep 'w' preservered.
 			// You can think of there really being 2 'z' values in 3d rendering
 			// One is used for getting perspective, that is dividing each point
@@ -57,6 +73,43 @@ public:
     float GetZ(){ return m_pos.GetZ(); }
     float GetW(){ return m_pos.GetW(); }
 
+    // Color as red, green, blue and alpha, each from 0 to 1.
+    // Vertices are white unless given another color.
+    void SetColor(Vector4f color) { m_color = color; }
+    Vector4f GetColor(){ return m_color; }
+
+
+    // Component by index: 0 is x, 1 is y, 2 is z and 3 is w.
+    float Get(int index){
+        switch(index){
+            case 0: return m_pos.GetX();
+            case 1: return m_pos.GetY();
+            case 2: return m_pos.GetZ();
+            default: return m_pos.GetW();
+        }
+    }
+
+    // The vertex part of the way to another, where 0 gives this vertex
+    // and 1 gives the other. The color is blended the same way.
+    Vertex Lerp(Vertex other, float amount){
+        return Vertex(m_pos.Add(other.m_pos.Sub(m_pos).Mul(amount)),
+                      m_color.Add(other.m_color.Sub(m_color).Mul(amount)));
+    }
+
+    // Outcode of a vertex in clip space (before the perspective divide):
+    // one bit for each plane of the view frustum the vertex lies outside
+    // of. Inside the frustum, x, y and z all lie between -w and w.
+    int ClipOutcode(){
+        float w = m_pos.GetW();
+        int code = 0;
+        if(m_pos.GetX() < -w){ code |= CLIP_LEFT; }
+        if(m_pos.GetX() > w){ code |= CLIP_RIGHT; }
+        if(m_pos.GetY() < -w){ code |= CLIP_BOTTOM; }
+        if(m_pos.GetY() > w){ code |= CLIP_TOP; }
+        if(m_pos.GetZ() < -w){ code |= CLIP_NEAR; }
+        if(m_pos.GetZ() > w){ code |= CLIP_FAR; }
+        return code;
+    }
 
     float TriangleArea(Vertex b, Vertex c){
         float x1 = b.GetX() - m_pos.GetX();
@@ -70,4 +123,5 @@ public:
 
 private:
 	Vector4f m_pos;
+	Vector4f m_color{1.0f, 1.0f, 1.0f, 1.0f};
 };
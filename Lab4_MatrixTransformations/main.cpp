@@ -6,10 +6,62 @@
 #include <QtGui>
 #include <QtOpenGL>
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
 // Lab application
 #include "Lab.h"
+#include "FrameSink.h"
+#include "RenderThread.h"
+#include "ScanBuffer.h"
+
+// Renders the spinning triangle into a video rather than a window, one frame
+// every 1/60 of a second of the animation, as fast as it can. Run as
+//
+//   Lab --frames 600 --output triangle.y4m
+//
+// with an output of "-" for stdout, or ending in .rgb for raw frames.
+int renderFrames(int frames, const std::string& output) {
+  const int framesPerSecond = 60;
+  const QSize size(800, 600);
+
+  ScanBuffer buffer(size.width(), size.height());
+  buffer.setSize(size);
+  FrameSink sink(output, FrameSink::formatFor(output), size, framesPerSecond);
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames && sink.good(); ++frame) {
+    RenderThread::renderScene(buffer, (float)frame / framesPerSecond);
+    sink.write(buffer.image());
+  }
+  float rendered = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+  if (!sink.close()) {
+    fprintf(stderr, "Unable to write %s\n", output.c_str());
+    return 1;
+  }
+  float written = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+  fprintf(stderr, "%u frames rendered in %.2f s, and written in %.2f s\n", sink.frameCount(), rendered, written);
+  return 0;
+}
 
 int main(int argc, char** argv) {
+  int frames = 0;
+  std::string output;
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (strcmp(argv[i], "--frames") == 0) {
+      frames = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--output") == 0) {
+      output = argv[++i];
+    }
+  }
+  if (frames > 0 && !output.empty()) {
+    return renderFrames(frames, output);
+  }
+
   QApplication a(argc, argv);
   QString appDir = a.applicationDirPath();
   QDir::setCurrent(appDir);
@@ -32,6 +32,8 @@ void UnitQuad::init(const QString& textureFile)
     texCoord << QVector2D(1.0, 1.0);
     idx << 0 << 1 << 2 << 2 << 1 << 3;
     Renderable::init(pos, norm, texCoord, idx, textureFile);
+    // A quad is flat and solid, so it hides whatever is behind it exactly
+    setOccluder(pos, idx);
 }
 
 void UnitQuad::update(const qint64 msSinceLastFrame)
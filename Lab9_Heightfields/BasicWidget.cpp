@@ -62,6 +62,10 @@ void BasicWidget::keyReleaseEvent(QKeyEvent* keyEvent)
     camera_.translateCamera(-1 * movementSpeed_ * gazeDirection);
     // Move back
     update();
+  } else if (keyEvent->key() == Qt::Key_C) {
+    occlusionCulling_ = !occlusionCulling_;
+    qDebug() << "Occlusion culling" << (occlusionCulling_ ? "on" : "off");
+    update();
   } else {
     qDebug() << "You Pressed an unsupported Key!";
   }
@@ -167,6 +171,21 @@ void BasicWidget::paintGL()
 
   for (auto renderable : renderables_) {
       renderable->update(msSinceRestart);
+  }
+
+  // Draw the occluders into the culler's depth buffer first, so whatever
+  // they hide need not be drawn at all
+  if (occlusionCulling_) {
+      culler_.beginFrame(camera_.getViewMatrix(), camera_.getProjectionMatrix());
+      for (auto renderable : renderables_) {
+          renderable->drawOccluder(culler_, world_);
+      }
+  }
+
+  for (auto renderable : renderables_) {
+      if (occlusionCulling_ && !renderable->isVisible(culler_, world_)) {
+          continue;
+      }
       // TODO:  Understand that the camera is now governing the view and projection matrices
       renderable->draw(world_, camera_.getViewMatrix(), camera_.getProjectionMatrix());
   }
@@ -22,6 +22,10 @@ private:
 
   QVector<Renderable*> renderables_;
 
+  // Leaves out renderables hidden behind others before they reach OpenGL
+  OcclusionCuller culler_;
+  bool occlusionCulling_ = true;
+
   QOpenGLDebugLogger logger_;
   bool isFilled_;
   // Mouse controls.
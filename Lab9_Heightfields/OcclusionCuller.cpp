@@ -0,0 +1,154 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// Points nearer the camera than this, or behind it, are not projected
+static const float NEAREST_W = 0.0001f;
+// How much nearer an occluder must be than a box to hide it, so that a
+// surface drawn as an occluder never hides itself, or a surface it meets
+static const float DEPTH_TOLERANCE = 1.0001f;
+
+OcclusionCuller::OcclusionCuller(int width, int height) : width_(width), height_(height)
+{
+	viewProjection_.setToIdentity();
+	depth_.fill(0.0f, width_ * height_);
+}
+
+OcclusionCuller::~OcclusionCuller()
+{}
+
+void OcclusionCuller::beginFrame(const QMatrix4x4& view, const QMatrix4x4& projection)
+{
+	viewProjection_ = projection * view;
+	depth_.fill(0.0f, width_ * height_);
+}
+
+void OcclusionCuller::drawOccluder(const QVector<QVector3D>& positions, const QVector<unsigned int>& indices, const QMatrix4x4& model)
+{
+	QMatrix4x4 transform = viewProjection_ * model;
+	QVector<QVector4D> clip;
+	clip.reserve(positions.size());
+	for (const QVector3D& position : positions) {
+		clip << transform * QVector4D(position, 1.0f);
+	}
+
+	for (int i = 0; i + 2 < indices.size(); i += 3) {
+		const QVector4D& c0 = clip.at(indices.at(i));
+		const QVector4D& c1 = clip.at(indices.at(i + 1));
+		const QVector4D& c2 = clip.at(indices.at(i + 2));
+		// Rather than clip a triangle reaching behind the camera, leave it
+		// out. An occluder missing a triangle only hides less.
+		if (c0.w() < NEAREST_W || c1.w() < NEAREST_W || c2.w() < NEAREST_W) {
+			continue;
+		}
+		fillTriangle(toScreen(c0), toScreen(c1), toScreen(c2));
+	}
+}
+
+bool OcclusionCuller::isVisible(const QVector3D& boundsMin, const QVector3D& boundsMax, const QMatrix4x4& model) const
+{
+	QMatrix4x4 transform = viewProjection_ * model;
+	float minX = FLT_MAX, minY = FLT_MAX;
+	float maxX = -FLT_MAX, maxY = -FLT_MAX;
+	float nearest = 0.0f;
+	for (int corner = 0; corner < 8; ++corner) {
+		QVector3D position((corner & 1) ? boundsMax.x() : boundsMin.x(),
+		                   (corner & 2) ? boundsMax.y() : boundsMin.y(),
+		                   (corner & 4) ? boundsMax.z() : boundsMin.z());
+		QVector4D clip = transform * QVector4D(position, 1.0f);
+		if (clip.w() < NEAREST_W) {
+			return true;
+		}
+		ScreenVertex vertex = toScreen(clip);
+		minX = std::min(minX, vertex.x);
+		minY = std::min(minY, vertex.y);
+		maxX = std::max(maxX, vertex.x);
+		maxY = std::max(maxY, vertex.y);
+		nearest = std::max(nearest, vertex.inverseW);
+	}
+
+	// Off the screen entirely
+	if (maxX < 0.0f || maxY < 0.0f || minX >= width_ || minY >= height_) {
+		return false;
+	}
+
+	// Every pixel the corners' rectangle touches, and the pixels around them.
+	// An occluder is only drawn where it covers the centers of pixels, so a
+	// pixel counts as hidden only when those around it are covered as well.
+	int x0 = (int)std::max(0.0f, minX - 1.0f);
+	int y0 = (int)std::max(0.0f, minY - 1.0f);
+	int x1 = (int)std::min(width_ - 1.0f, maxX + 1.0f);
+	int y1 = (int)std::min(height_ - 1.0f, maxY + 1.0f);
+	float limit = nearest * DEPTH_TOLERANCE;
+	for (int y = y0; y <= y1; ++y) {
+		const float* row = depth_.constData() + y * width_;
+		for (int x = x0; x <= x1; ++x) {
+			if (row[x] <= limit) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+OcclusionCuller::ScreenVertex OcclusionCuller::toScreen(const QVector4D& clip) const
+{
+	ScreenVertex vertex;
+	vertex.inverseW = 1.0f / clip.w();
+	vertex.x = (clip.x() * vertex.inverseW + 1.0f) * 0.5f * width_;
+	vertex.y = (1.0f - clip.y() * vertex.inverseW) * 0.5f * height_;
+	return vertex;
+}
+
+void OcclusionCuller::fillTriangle(const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2)
+{
+	// Occluders hide what is behind them from either side, so a triangle is
+	// filled whichever way round it winds
+	float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+	if (area == 0.0f) {
+		return;
+	}
+
+	// The pixels whose centers lie within the triangle's bounding box
+	float minX = std::max(0.0f, std::ceil(std::min(v0.x, std::min(v1.x, v2.x)) - 0.5f));
+	float minY = std::max(0.0f, std::ceil(std::min(v0.y, std::min(v1.y, v2.y)) - 0.5f));
+	float maxX = std::min(width_ - 1.0f, std::floor(std::max(v0.x, std::max(v1.x, v2.x)) - 0.5f));
+	float maxY = std::min(height_ - 1.0f, std::floor(std::max(v0.y, std::max(v1.y, v2.y)) - 0.5f));
+	if (minX > maxX || minY > maxY) {
+		return;
+	}
+	int x0 = (int)minX, y0 = (int)minY;
+	int x1 = (int)maxX, y1 = (int)maxY;
+
+	// As in the software rasterizer, an edge function for each edge says how
+	// far a point lies inside it. Divided by the area, they are the point's
+	// weights for each vertex, which also interpolate its 1/w, and each of
+	// them changes by a fixed step from one pixel to the next.
+	float inverseArea = 1.0f / area;
+	float stepX0 = (v1.y - v2.y) * inverseArea, stepY0 = (v2.x - v1.x) * inverseArea;
+	float stepX1 = (v2.y - v0.y) * inverseArea, stepY1 = (v0.x - v2.x) * inverseArea;
+	float stepX2 = (v0.y - v1.y) * inverseArea, stepY2 = (v1.x - v0.x) * inverseArea;
+	float startX = x0 + 0.5f, startY = y0 + 0.5f;
+	float rowWeight0 = ((v2.x - v1.x) * (startY - v1.y) - (v2.y - v1.y) * (startX - v1.x)) * inverseArea;
+	float rowWeight1 = ((v0.x - v2.x) * (startY - v2.y) - (v0.y - v2.y) * (startX - v2.x)) * inverseArea;
+	float rowWeight2 = ((v1.x - v0.x) * (startY - v0.y) - (v1.y - v0.y) * (startX - v0.x)) * inverseArea;
+
+	for (int y = y0; y <= y1; ++y) {
+		float weight0 = rowWeight0, weight1 = rowWeight1, weight2 = rowWeight2;
+		float* row = depth_.data() + y * width_;
+		for (int x = x0; x <= x1; ++x) {
+			if (weight0 >= 0.0f && weight1 >= 0.0f && weight2 >= 0.0f) {
+				float inverseW = weight0 * v0.inverseW + weight1 * v1.inverseW + weight2 * v2.inverseW;
+				row[x] = std::max(row[x], inverseW);
+			}
+			weight0 += stepX0;
+			weight1 += stepX1;
+			weight2 += stepX2;
+		}
+		rowWeight0 += stepY0;
+		rowWeight1 += stepY1;
+		rowWeight2 += stepY2;
+	}
+}
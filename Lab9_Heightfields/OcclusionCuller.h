@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QtGui/QMatrix4x4>
+#include <QtGui/QVector3D>
+#include <QtGui/QVector4D>
+#include <QtCore/QVector>
+
+/**
+ * Decides which renderables are hidden behind others before they are sent to
+ * OpenGL, by drawing the scene's occluders into a small depth buffer on the
+ * CPU, the way the software rasterizer from the first labs fills triangles.
+ *
+ * Each frame the occluders are drawn first, then each renderable's bounding
+ * box is tested against what they left in the buffer. A box that lies behind
+ * the occluders at every pixel it covers, or off the screen entirely, is
+ * hidden, and its renderable need not be drawn.
+ *
+ * An occluder must never cover more than the surface it stands in for, or
+ * something in plain sight could be culled: a renderable's own triangles, or
+ * a simpler mesh lying within them, will do, but its bounding box will not.
+ * Past that, the test errs towards drawing: a box reaching behind the camera
+ * counts as visible, as does one partly hidden, and a pixel only counts as
+ * hidden when the pixels around it are covered as well. The one thing it
+ * gets wrong is a crack between two occluders narrower than a pixel of its
+ * buffer, which it takes to be closed.
+ */
+class OcclusionCuller
+{
+public:
+	// The depth buffer is a fixed, small size whatever the size of the window.
+	// It is stretched over the whole of the window, so its pixels need not
+	// be square.
+	OcclusionCuller(int width = 256, int height = 128);
+	virtual ~OcclusionCuller();
+
+	// Clears the depth buffer for a frame seen through the given view and
+	// projection matrices.
+	void beginFrame(const QMatrix4x4& view, const QMatrix4x4& projection);
+
+	// Draws an occluder's triangles, as a list of three indices each, into the
+	// depth buffer.
+	void drawOccluder(const QVector<QVector3D>& positions, const QVector<unsigned int>& indices, const QMatrix4x4& model);
+
+	// Whether any of the box from boundsMin to boundsMax, placed by the model
+	// matrix, might be seen in front of the occluders drawn so far.
+	bool isVisible(const QVector3D& boundsMin, const QVector3D& boundsMax, const QMatrix4x4& model) const;
+
+private:
+	// A vertex on the depth buffer, with its distance stored as 1/w, which
+	// unlike w can be interpolated straight across the screen
+	struct ScreenVertex {
+		float x, y, inverseW;
+	};
+
+	ScreenVertex toScreen(const QVector4D& clip) const;
+	void fillTriangle(const ScreenVertex& v0, const ScreenVertex& v1, const ScreenVertex& v2);
+
+	int width_;
+	int height_;
+	QMatrix4x4 viewProjection_;
+	// 1/w of the nearest occluder at each pixel, 0 where there is none
+	QVector<float> depth_;
+};
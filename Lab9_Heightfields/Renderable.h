@@ -4,6 +4,8 @@
 #include <QtGui>
 #include <QtOpenGL>
 
+#include "OcclusionCuller.h"
+
 class Renderable
 {
 protected:
@@ -31,8 +33,17 @@ protected:
 	float rotationSpeed_;
 	float rotationAngle_;
 
+	// The box around our positions, before the model matrix places it
+	QVector3D boundsMin_;
+	QVector3D boundsMax_;
+	// Triangles standing in for us when hiding other renderables, if any
+	QVector<QVector3D> occluderPositions_;
+	QVector<unsigned int> occluderIndices_;
+
 	// Create our shader and fix it up
 	void createShaders();
+	// The model matrix we are drawn with
+	virtual QMatrix4x4 modelTransform(const QMatrix4x4& world) const;
 
 public:
 	Renderable();
@@ -49,6 +60,15 @@ public:
 	void setModelMatrix(const QMatrix4x4& transform);
 	void setRotationAxis(const QVector3D& axis);
 	void setRotationSpeed(float speed);
+
+	// Hide other renderables behind the given triangles, which must lie within
+	// our own surface wherever we are drawn.
+	void setOccluder(const QVector<QVector3D>& positions, const QVector<unsigned int>& indexes);
+	// Draw our occluder, if we have one, into the culler's depth buffer.
+	void drawOccluder(OcclusionCuller& culler, const QMatrix4x4& world) const;
+	// Whether the culler finds any of us might be seen.
+	bool isVisible(const OcclusionCuller& culler, const QMatrix4x4& world) const;
+
 	void toggleFillMode();
 
 private:
@@ -83,9 +83,8 @@ void TerrainQuad::update(const qint64 msSinceLastFrame)
     }
 }
 
-void TerrainQuad::draw(const QMatrix4x4& world, const QMatrix4x4& view, const QMatrix4x4& projection)
+QMatrix4x4 TerrainQuad::modelTransform(const QMatrix4x4& world) const
 {
-    // Create our model matrix.
     QMatrix4x4 rotMatrix;
     rotMatrix.setToIdentity();
     rotMatrix.translate(0.5, 0.0, 0.5);
@@ -93,11 +92,13 @@ void TerrainQuad::draw(const QMatrix4x4& world, const QMatrix4x4& view, const QM
     rotMatrix.translate(-0.5, 0.0, -0.5);
 
     // incorporate a real world transform if want it.
-    QMatrix4x4 modelMat;
-    modelMat.setToIdentity();
-    modelMat = modelMatrix_;
-    modelMat = modelMat * rotMatrix;
-    modelMat = world * modelMat;
+    return world * modelMatrix_ * rotMatrix;
+}
+
+void TerrainQuad::draw(const QMatrix4x4& world, const QMatrix4x4& view, const QMatrix4x4& projection)
+{
+    // Create our model matrix.
+    QMatrix4x4 modelMat = modelTransform(world);
     // Make sure our state is what we want
     shader_.bind();
     // Set our matrix uniforms!
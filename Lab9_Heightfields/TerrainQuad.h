@@ -10,6 +10,9 @@ protected:
 	unsigned int numIdxPerStrip_;
 	unsigned int numStrips_;
 	QOpenGLTexture heightTexture_;
+
+	// We spin about our own center rather than our corner
+	virtual QMatrix4x4 modelTransform(const QMatrix4x4& world) const override;
 public:
 	TerrainQuad();
 	virtual ~TerrainQuad();